@@ -30,6 +30,7 @@ LOCAL_SRC_FILES += $(SRC_DIR)/layers/vk_layer_config.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/utils/vk_layer_extension_utils.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/error_message/logging.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/utils/vk_layer_utils.cpp
+LOCAL_SRC_FILES += $(SRC_DIR)/layers/utils/thread_pool.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/generated/vk_format_utils.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/external/xxhash.cpp
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/$(SRC_DIR)/layers/generated \
@@ -84,7 +85,9 @@ LOCAL_SRC_FILES += $(SRC_DIR)/layers/generated/command_validation.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/generated/dynamic_state_helper.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/gpu_validation/gpu_validation.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/gpu_validation/gpu_utils.cpp
+LOCAL_SRC_FILES += $(SRC_DIR)/layers/gpu_validation/instrumented_shader_cache.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/gpu_validation/debug_printf.cpp
+LOCAL_SRC_FILES += $(SRC_DIR)/layers/gpu_validation/debug_printf_log.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/best_practices/best_practices_utils.cpp
 LOCAL_SRC_FILES += ${SRC_DIR}/layers/best_practices/bp_buffer.cpp
 LOCAL_SRC_FILES += ${SRC_DIR}/layers/best_practices/bp_cmd_buffer.cpp
@@ -102,6 +105,7 @@ LOCAL_SRC_FILES += ${SRC_DIR}/layers/best_practices/bp_synchronization.cpp
 LOCAL_SRC_FILES += ${SRC_DIR}/layers/best_practices/bp_video.cpp
 LOCAL_SRC_FILES += ${SRC_DIR}/layers/best_practices/bp_wsi.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/generated/best_practices.cpp
+LOCAL_SRC_FILES += $(SRC_DIR)/layers/sync/sync_stats.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/sync/sync_utils.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/sync/sync_vuid_maps.cpp
 LOCAL_SRC_FILES += $(SRC_DIR)/layers/error_message/core_error_location.cpp
@@ -235,6 +239,8 @@ LOCAL_SRC_FILES += $(SRC_DIR)/tests/framework/layer_validation_tests.cpp \
                    $(SRC_DIR)/tests/positive/ray_tracing_pipeline.cpp \
                    $(SRC_DIR)/tests/positive/ycbcr.cpp \
                    $(SRC_DIR)/tests/negative/sync_val.cpp \
+                   $(SRC_DIR)/tests/containers/range_index.cpp \
+                   $(SRC_DIR)/tests/containers/range_map.cpp \
                    $(SRC_DIR)/tests/containers/small_vector.cpp \
                    $(SRC_DIR)/tests/framework/binding.cpp \
                    $(SRC_DIR)/tests/framework/test_framework_android.cpp \
@@ -0,0 +1,90 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sparse_container {
+// range_index
+//
+// Read-only copy of a map of sorted, disjoint ranges, such as a range_map, for finding the range that includes an index.
+// An index is in the last range that begins at or below it. The range begins are also stored as an implicit search tree
+// (Eytzinger layout: node k has its children at 2k and 2k + 1), which keeps the first levels of every search in the same few
+// cache lines.
+template <typename Range, typename Mapped>
+class range_index {
+  public:
+    using key_type = Range;
+    using index_type = typename Range::index_type;
+    using mapped_type = Mapped;
+    using value_type = std::pair<key_type, mapped_type>;
+
+    range_index() : tree_(1) {}
+
+    template <typename Map>
+    explicit range_index(const Map &map) {
+        entries_.reserve(map.size());
+        for (const auto &entry : map) {
+            entries_.emplace_back(entry.first, entry.second);
+        }
+        tree_.resize(entries_.size() + 1);
+        build_tree(0, 1);
+    }
+
+    // The entries in the order of their ranges
+    const std::vector<value_type> &entries() const { return entries_; }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    // Returns the entry whose range includes index, or nullptr
+    value_type *find(const index_type &index) {
+        // Find the node of the first range that begins above index
+        size_t upper_node = 0;
+        for (size_t node = 1; node < tree_.size();) {
+            if (tree_[node].first > index) {
+                upper_node = node;
+                node = 2 * node;
+            } else {
+                node = 2 * node + 1;
+            }
+        }
+        const size_t upper = upper_node ? tree_[upper_node].second : entries_.size();
+        if (upper == 0 || !entries_[upper - 1].first.includes(index)) {
+            return nullptr;
+        }
+        return &entries_[upper - 1];
+    }
+    const value_type *find(const index_type &index) const { return const_cast<range_index *>(this)->find(index); }
+
+  private:
+    // Fills the subtree of node in order, starting with entry. Returns the first entry past the subtree.
+    size_t build_tree(size_t entry, size_t node) {
+        if (node < tree_.size()) {
+            entry = build_tree(entry, 2 * node);
+            tree_[node] = {entries_[entry].first.begin, entry};
+            entry = build_tree(entry + 1, 2 * node + 1);
+        }
+        return entry;
+    }
+
+    std::vector<value_type> entries_;
+    std::vector<std::pair<index_type, size_t>> tree_;  // range begin and entry, node 0 is unused
+};
+
+}  // namespace sparse_container
@@ -1897,14 +1897,14 @@ bool update_range_value(Map &map, const Range &range, MapValue &&value, value_pr
     return updated;
 }
 
-//  combines directly adjacent ranges with equal RangeMap::mapped_type .
-template <typename RangeMap>
-void consolidate(RangeMap &map) {
+//  combines directly adjacent ranges with equal RangeMap::mapped_type, starting at current, for as long as in_bounds is true for
+//  the start of a merge range.
+template <typename RangeMap, typename Predicate>
+void consolidate(RangeMap &map, typename RangeMap::iterator current, const Predicate &in_bounds) {
     using Value = typename RangeMap::value_type;
     using Key = typename RangeMap::key_type;
     using It = typename RangeMap::iterator;
 
-    It current = map.begin();
     const It map_end = map.end();
 
     // To be included in a merge range there must be no gap in the Key space, and the mapped_type values must match
@@ -1912,7 +1912,7 @@ void consolidate(RangeMap &map) {
         return cur->first.begin == last->first.end && cur->second == last->second;
     };
 
-    while (current != map_end) {
+    while (current != map_end && in_bounds(current)) {
         // Establish a trival merge range at the current location, advancing current. Merge range is inclusive of merge_last
         const It merge_first = current;
         It merge_last = current;
@@ -1936,4 +1936,23 @@ void consolidate(RangeMap &map) {
     }
 }
 
+//  combines directly adjacent ranges with equal RangeMap::mapped_type .
+template <typename RangeMap>
+void consolidate(RangeMap &map) {
+    consolidate(map, map.begin(), [](const typename RangeMap::iterator &) { return true; });
+}
+
+//  combines directly adjacent ranges with equal RangeMap::mapped_type, limited to the ranges intersecting or directly adjacent
+//  to bounds.
+template <typename RangeMap>
+void consolidate(RangeMap &map, const typename RangeMap::key_type &bounds) {
+    auto first = map.lower_bound(bounds);
+    // The preceding range may merge with the first range within bounds
+    if (first != map.begin()) {
+        --first;
+    }
+    const auto bounds_end = bounds.end;
+    consolidate(map, first, [bounds_end](const typename RangeMap::iterator &pos) { return pos->first.begin <= bounds_end; });
+}
+
 }  // namespace sparse_container
@@ -19,15 +19,11 @@
  * This file deals with anything related to Phyiscal Devices, Logical Devices, or Device Queues Families, Device Masks, etc
  */
 
+#include <algorithm>
 #include <fstream>
 #include <string>
-#include <sys/stat.h>
 #include <vector>
 
-#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
-#include <unistd.h>
-#endif
-
 #include "generated/vk_enum_string_helper.h"
 #include "generated/chassis.h"
 #include "core_validation.h"
@@ -438,27 +434,12 @@ void CoreChecks::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
             cb_state->SetImageViewInitialLayout(iv_state, layout);
         });
 
+    spirv_environment_key_ = MakeValidationEnvironmentKey(
+        PickSpirvEnv(api_version, IsExtEnabled(device_extensions.vk_khr_spirv_1_4)), device_extensions, enabled_features);
+
     // Allocate shader validation cache
     if (!disabled[shader_validation_caching] && !disabled[shader_validation] && !core_validation_cache) {
-        auto tmp_path = GetEnvironment("XDG_CACHE_HOME");
-        if (!tmp_path.size()) {
-            auto cachepath = GetEnvironment("HOME") + "/.cache";
-            struct stat info;
-            if (stat(cachepath.c_str(), &info) == 0) {
-                if ((info.st_mode & S_IFMT) == S_IFDIR) {
-                    tmp_path = cachepath;
-                }
-            }
-        }
-        if (!tmp_path.size()) tmp_path = GetEnvironment("TMPDIR");
-        if (!tmp_path.size()) tmp_path = GetEnvironment("TMP");
-        if (!tmp_path.size()) tmp_path = GetEnvironment("TEMP");
-        if (!tmp_path.size()) tmp_path = "/tmp";
-        validation_cache_path = tmp_path + "/shader_validation_cache";
-#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
-        validation_cache_path += "-" + std::to_string(getuid());
-#endif
-        validation_cache_path += ".bin";
+        validation_cache_path = GetLayerCacheFilePath("shader_validation_cache");
 
         std::vector<char> validation_cache_data;
         std::ifstream read_file(validation_cache_path.c_str(), std::ios::in | std::ios::binary);
@@ -477,11 +458,31 @@ void CoreChecks::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
         cacheCreateInfo.flags = 0;
         CoreLayerCreateValidationCacheEXT(device, &cacheCreateInfo, nullptr, &core_validation_cache);
     }
+
+    std::string stats_string = GetLayerOptionOrEnvVar("khronos_validation.shader_module_stats");
+    std::transform(stats_string.begin(), stats_string.end(), stats_string.begin(), ::tolower);
+    report_shader_module_stats_ = !stats_string.compare("true");
 }
 
 void CoreChecks::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
     if (!device) return;
 
+    // Messages of deferred operations that were never joined to completion
+    for (const auto &entry : deferred_pipeline_validation_.snapshot()) {
+        FinishDeferredPipelineValidation(entry.first);
+    }
+
+    if (report_shader_module_stats_) {
+        const auto stats = SpirvModuleCache::Instance().GetStats();
+        LogInfo(device, "UNASSIGNED-ShaderModule-Stats",
+                "SPIR-V parsing since the process started, cumulative across all devices: %" PRIu64 " modules parsed in %" PRIu64
+                " us, %" PRIu64
+                " modules shared an identical earlier parse (%" PRIu64 " bytes of SPIR-V not stored again), %" PRIu64
+                " parsed modules alive.",
+                stats.parsed_modules, stats.parse_nanoseconds / 1000, stats.shared_modules, stats.shared_bytes,
+                stats.live_parsed_modules);
+    }
+
     StateTracker::PreCallRecordDestroyDevice(device, pAllocator);
 
     if (core_validation_cache) {
@@ -311,37 +311,31 @@ bool CoreChecks::ValidateCmdBufImageLayouts(const Location &loc, const CMD_BUFFE
         assert(global_map);
         auto global_map_guard = global_map->ReadLock();
 
-        // Note: don't know if it would matter
-        // if (global_map->empty() && overlay_map->empty()) // skip this next loop...;
-
-        auto pos = layout_map.begin();
-        const auto end = layout_map.end();
-        sparse_container::parallel_iterator<const GlobalImageLayoutRangeMap> current_layout(*overlay_map, *global_map,
-                                                                                            pos->first.begin);
-        while (pos != end) {
-            VkImageLayout initial_layout = pos->second.initial_layout;
-            assert(initial_layout != image_layout_map::kInvalidLayout);
-            if (initial_layout == image_layout_map::kInvalidLayout) {
+        // Unless an earlier command buffer of the submission changed them, the current layouts are the ones of the global map. If
+        // it has not changed since they last matched the initial layouts, they still do.
+        const uint64_t global_generation = global_map->Generation();
+        if (overlay_map->empty()) {
+            std::lock_guard<std::mutex> guard(cb_state.validated_layout_generations_lock);
+            const auto validated_it = cb_state.validated_layout_generations.find(image_state);
+            if (validated_it != cb_state.validated_layout_generations.end() && validated_it->second == global_generation) {
+                sparse_container::splice(*overlay_map, subres_map->GetLayoutMap(), GlobalLayoutUpdater());
                 continue;
             }
+        }
 
-            VkImageLayout image_layout = kInvalidLayout;
-
-            if (current_layout->range.empty()) break;  // When we are past the end of data in overlay and global... stop looking
-            if (current_layout->pos_A->valid) {        // pos_A denotes the overlay map in the parallel iterator
-                image_layout = current_layout->pos_A->lower_bound->second;
-            } else if (current_layout->pos_B->valid) {  // pos_B denotes the global map in the parallel iterator
-                image_layout = current_layout->pos_B->lower_bound->second;
-            }
-            const auto intersected_range = pos->first & current_layout->range;
+        using LayoutRange = image_layout_map::ImageSubresourceLayoutMap::RangeType;
+        bool layouts_match = true;
+        // Reports every subresource of range that is expected in initial_layout but is in image_layout
+        auto validate_layout = [&](const LayoutRange &range, VkImageLayout initial_layout, VkImageLayout image_layout) {
             if (initial_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
                 // TODO: Set memory invalid which is in mem_tracker currently
             } else if (image_layout != initial_layout) {
-                const auto aspect_mask = image_state->subresource_encoder.Decode(intersected_range.begin).aspectMask;
+                const auto aspect_mask = image_state->subresource_encoder.Decode(range.begin).aspectMask;
                 const bool matches = ImageLayoutMatches(aspect_mask, image_layout, initial_layout);
                 if (!matches) {
+                    layouts_match = false;
                     // We can report all the errors for the intersected range directly
-                    for (auto index : sparse_container::range_view<decltype(intersected_range)>(intersected_range)) {
+                    for (auto index : sparse_container::range_view<LayoutRange>(range)) {
                         const auto subresource = image_state->subresource_encoder.Decode(index);
                         skip |= LogError(cb_state.commandBuffer(), kVUID_Core_DrawState_InvalidImageLayout,
                                          "%s command buffer %s expects %s (subresource: aspectMask 0x%x array layer %" PRIu32
@@ -355,15 +349,52 @@ bool CoreChecks::ValidateCmdBufImageLayouts(const Location &loc, const CMD_BUFFE
                     }
                 }
             }
-            if (pos->first.includes(intersected_range.end)) {
-                current_layout.seek(intersected_range.end);
-            } else {
-                ++pos;
-                if (pos != end) {
-                    current_layout.seek(pos->first.begin);
+        };
+
+        VkImageLayout uniform_layout = kInvalidLayout;
+        if (overlay_map->empty() && global_map->UniformLayout(uniform_layout)) {
+            // The whole image is in one layout, which every initial layout is compared to without walking the global map
+            for (const auto &entry : layout_map) {
+                assert(entry.second.initial_layout != image_layout_map::kInvalidLayout);
+                validate_layout(entry.first, entry.second.initial_layout, uniform_layout);
+            }
+        } else {
+            auto pos = layout_map.begin();
+            const auto end = layout_map.end();
+            sparse_container::parallel_iterator<const GlobalImageLayoutRangeMap> current_layout(*overlay_map, *global_map,
+                                                                                                pos->first.begin);
+            while (pos != end) {
+                VkImageLayout initial_layout = pos->second.initial_layout;
+                assert(initial_layout != image_layout_map::kInvalidLayout);
+                if (initial_layout == image_layout_map::kInvalidLayout) {
+                    continue;
+                }
+
+                VkImageLayout image_layout = kInvalidLayout;
+
+                // When we are past the end of data in overlay and global... stop looking
+                if (current_layout->range.empty()) break;
+                if (current_layout->pos_A->valid) {  // pos_A denotes the overlay map in the parallel iterator
+                    image_layout = current_layout->pos_A->lower_bound->second;
+                } else if (current_layout->pos_B->valid) {  // pos_B denotes the global map in the parallel iterator
+                    image_layout = current_layout->pos_B->lower_bound->second;
+                }
+                const auto intersected_range = pos->first & current_layout->range;
+                validate_layout(intersected_range, initial_layout, image_layout);
+                if (pos->first.includes(intersected_range.end)) {
+                    current_layout.seek(intersected_range.end);
+                } else {
+                    ++pos;
+                    if (pos != end) {
+                        current_layout.seek(pos->first.begin);
+                    }
                 }
             }
         }
+        if (layouts_match && overlay_map->empty()) {
+            std::lock_guard<std::mutex> guard(cb_state.validated_layout_generations_lock);
+            cb_state.validated_layout_generations[image_state] = global_generation;
+        }
         // Update all layout set operations (which will be a subset of the initial_layouts)
         sparse_container::splice(*overlay_map, subres_map->GetLayoutMap(), GlobalLayoutUpdater());
     }
@@ -376,7 +407,10 @@ void CoreChecks::UpdateCmdBufImageLayouts(const CMD_BUFFER_STATE *cb_state) {
         const auto *image_state = layout_map_entry.first;
         const auto &subres_map = layout_map_entry.second;
         auto guard = image_state->layout_range_map->WriteLock();
-        sparse_container::splice(*image_state->layout_range_map, subres_map->GetLayoutMap(), GlobalLayoutUpdater());
+        if (sparse_container::splice(*image_state->layout_range_map, subres_map->GetLayoutMap(), GlobalLayoutUpdater())) {
+            image_state->layout_range_map->Consolidate();
+            image_state->layout_range_map->LayoutsChanged();
+        }
     }
 }
 
@@ -30,14 +30,15 @@ bool CoreChecks::PreCallValidateCreateComputePipelines(VkDevice device, VkPipeli
                                                        const VkComputePipelineCreateInfo *pCreateInfos,
                                                        const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                                        void *ccpl_state_data) const {
-    bool skip = StateTracker::PreCallValidateCreateComputePipelines(device, pipelineCache, count, pCreateInfos, pAllocator,
-                                                                    pPipelines, ccpl_state_data);
+    const bool tracker_skip = StateTracker::PreCallValidateCreateComputePipelines(device, pipelineCache, count, pCreateInfos,
+                                                                                  pAllocator, pPipelines, ccpl_state_data);
 
     auto *ccpl_state = reinterpret_cast<create_compute_pipeline_api_state *>(ccpl_state_data);
-    for (uint32_t i = 0; i < count; i++) {
+    const bool pipelines_skip = ForEachPipelineCreateIndex(count, [&](uint32_t i) {
+        bool skip = false;
         const PIPELINE_STATE *pipeline = ccpl_state->pipe_state[i].get();
         if (!pipeline) {
-            continue;
+            return skip;
         }
         skip |= ValidateComputePipelineShaderState(*pipeline);
         skip |= ValidateShaderModuleId(*pipeline);
@@ -50,6 +51,7 @@ bool CoreChecks::PreCallValidateCreateComputePipelines(VkDevice device, VkPipeli
             parameter_name << "vkCreateComputePipelines(): pCreateInfos[" << i << "]";
             skip |= ValidatePipelineRobustnessCreateInfo(*pipeline, parameter_name.str().c_str(), *pipeline_robustness_info);
         }
-    }
-    return skip;
+        return skip;
+    });
+    return tracker_skip || pipelines_skip;
 }
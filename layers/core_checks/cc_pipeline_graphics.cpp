@@ -30,15 +30,17 @@ bool CoreChecks::PreCallValidateCreateGraphicsPipelines(VkDevice device, VkPipel
                                                         const VkGraphicsPipelineCreateInfo *pCreateInfos,
                                                         const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                                         void *cgpl_state_data) const {
-    bool skip = StateTracker::PreCallValidateCreateGraphicsPipelines(device, pipelineCache, count, pCreateInfos, pAllocator,
-                                                                     pPipelines, cgpl_state_data);
+    const bool tracker_skip = StateTracker::PreCallValidateCreateGraphicsPipelines(device, pipelineCache, count, pCreateInfos,
+                                                                                   pAllocator, pPipelines, cgpl_state_data);
     create_graphics_pipeline_api_state *cgpl_state = reinterpret_cast<create_graphics_pipeline_api_state *>(cgpl_state_data);
 
-    for (uint32_t i = 0; i < count; i++) {
+    const bool pipelines_skip = ForEachPipelineCreateIndex(count, [&](uint32_t i) {
+        bool skip = false;
         skip |= ValidateGraphicsPipeline(*cgpl_state->pipe_state[i].get());
         skip |= ValidatePipelineDerivatives(cgpl_state->pipe_state, i);
-    }
-    return skip;
+        return skip;
+    });
+    return tracker_skip || pipelines_skip;
 }
 
 bool CoreChecks::ValidateGraphicsPipeline(const PIPELINE_STATE &pipeline) const {
@@ -18,13 +18,17 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "generated/vk_enum_string_helper.h"
 #include "generated/chassis.h"
 #include "core_validation.h"
 
 bool CoreChecks::ValidateRayTracingPipeline(const PIPELINE_STATE &pipeline,
                                             const safe_VkRayTracingPipelineCreateInfoCommon &create_info,
-                                            VkPipelineCreateFlags flags, bool isKHR) const {
+                                            VkPipelineCreateFlags flags, bool isKHR, bool validate_stages) const {
     bool skip = false;
 
     if (isKHR) {
@@ -84,8 +88,11 @@ bool CoreChecks::ValidateRayTracingPipeline(const PIPELINE_STATE &pipeline,
     }
     const auto *groups = create_info.ptr()->pGroups;
 
+    // With a deferred operation only the checks of the shader stages that must stop the call are run here, the rest are run by the
+    // threads joined to it (see DeferredPipelineValidation)
     for (auto &stage_state : pipeline.stage_states) {
-        skip |= ValidatePipelineShaderStage(pipeline, stage_state);
+        skip |= ValidatePipelineShaderStage(pipeline, stage_state,
+                                            validate_stages ? ShaderStageChecks::kAll : ShaderStageChecks::kGating);
     }
 
     if (const auto *pipeline_robustness_info = LvlFindInChain<VkPipelineRobustnessCreateInfoEXT>(create_info.pNext);
@@ -179,14 +186,15 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesNV(VkDevice device, VkP
                                                             const VkRayTracingPipelineCreateInfoNV *pCreateInfos,
                                                             const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                                             void *crtpl_state_data) const {
-    bool skip = StateTracker::PreCallValidateCreateRayTracingPipelinesNV(device, pipelineCache, count, pCreateInfos, pAllocator,
-                                                                         pPipelines, crtpl_state_data);
+    const bool tracker_skip = StateTracker::PreCallValidateCreateRayTracingPipelinesNV(device, pipelineCache, count, pCreateInfos,
+                                                                                       pAllocator, pPipelines, crtpl_state_data);
 
     auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_api_state *>(crtpl_state_data);
-    for (uint32_t i = 0; i < count; i++) {
+    const bool pipelines_skip = ForEachPipelineCreateIndex(count, [&](uint32_t i) {
+        bool skip = false;
         const PIPELINE_STATE *pipeline = crtpl_state->pipe_state[i].get();
         if (!pipeline) {
-            continue;
+            return skip;
         }
         using CIType = vvl::base_type<decltype(pCreateInfos)>;
         if (pipeline->create_flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) {
@@ -212,8 +220,9 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesNV(VkDevice device, VkP
         skip |= ValidateShaderModuleId(*pipeline);
         skip |= ValidatePipelineCacheControlFlags(pCreateInfos[i].flags, i, "vkCreateRayTracingPipelinesNV",
                                                   "VUID-VkRayTracingPipelineCreateInfoNV-pipelineCreationCacheControl-02905");
-    }
-    return skip;
+        return skip;
+    });
+    return tracker_skip || pipelines_skip;
 }
 
 bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, VkDeferredOperationKHR deferredOperation,
@@ -221,14 +230,16 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, Vk
                                                              const VkRayTracingPipelineCreateInfoKHR *pCreateInfos,
                                                              const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                                              void *crtpl_state_data) const {
-    bool skip = StateTracker::PreCallValidateCreateRayTracingPipelinesKHR(device, deferredOperation, pipelineCache, count,
-                                                                          pCreateInfos, pAllocator, pPipelines, crtpl_state_data);
+    const bool tracker_skip = StateTracker::PreCallValidateCreateRayTracingPipelinesKHR(device, deferredOperation, pipelineCache,
+                                                                                        count, pCreateInfos, pAllocator, pPipelines,
+                                                                                        crtpl_state_data);
 
     auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_khr_api_state *>(crtpl_state_data);
-    for (uint32_t i = 0; i < count; i++) {
+    const bool pipelines_skip = ForEachPipelineCreateIndex(count, [&](uint32_t i) {
+        bool skip = false;
         const PIPELINE_STATE *pipeline = crtpl_state->pipe_state[i].get();
         if (!pipeline) {
-            continue;
+            return skip;
         }
         using CIType = vvl::base_type<decltype(pCreateInfos)>;
         if (pipeline->create_flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) {
@@ -250,7 +261,8 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, Vk
                              i);
             }
         }
-        skip |= ValidateRayTracingPipeline(*pipeline, pipeline->GetCreateInfo<CIType>(), pCreateInfos[i].flags, /*isKHR*/ true);
+        skip |= ValidateRayTracingPipeline(*pipeline, pipeline->GetCreateInfo<CIType>(), pCreateInfos[i].flags, /*isKHR*/ true,
+                                           deferredOperation == VK_NULL_HANDLE);
         skip |= ValidateShaderModuleId(*pipeline);
         skip |= ValidatePipelineCacheControlFlags(pCreateInfos[i].flags, i, "vkCreateRayTracingPipelinesKHR",
                                                   "VUID-VkRayTracingPipelineCreateInfoKHR-pipelineCreationCacheControl-02905");
@@ -301,7 +313,138 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, Vk
                                  i);
             }
         }
+        // A failed call never reaches the driver, so there is no deferred work to join; report the rest of the stage errors now
+        if (skip && deferredOperation != VK_NULL_HANDLE) {
+            for (auto &stage_state : pipeline->stage_states) {
+                if (stage_state.entrypoint) {
+                    skip |= ValidatePipelineShaderStage(*pipeline, stage_state, ShaderStageChecks::kDeferrable);
+                }
+            }
+        }
+        return skip;
+    });
+
+    return tracker_skip || pipelines_skip;
+}
+
+// The deferrable checks of the shader stages of a vkCreateRayTracingPipelinesKHR call made with a deferred operation. Each stage is
+// a task claimed by one of the threads the application joins to the operation, so the layer's SPIR-V processing scales with the
+// threads the application already devotes to pipeline compilation. Messages are held back per stage and emitted in stage order by
+// the thread that finishes the last one. The call was already made, so they can't fail it.
+class DeferredPipelineValidation {
+  public:
+    explicit DeferredPipelineValidation(std::vector<std::shared_ptr<const PIPELINE_STATE>> &&pipelines)
+        : pipelines_(std::move(pipelines)) {
+        for (uint32_t pipeline_index = 0; pipeline_index < pipelines_.size(); ++pipeline_index) {
+            if (!pipelines_[pipeline_index]) continue;
+            const auto &stage_states = pipelines_[pipeline_index]->stage_states;
+            for (uint32_t stage_index = 0; stage_index < stage_states.size(); ++stage_index) {
+                // Stages without an entrypoint failed the call when it was validated
+                if (stage_states[stage_index].entrypoint) {
+                    tasks_.emplace_back(pipeline_index, stage_index);
+                }
+            }
+        }
+        messages_.resize(tasks_.size());
     }
 
-    return skip;
+    bool Empty() const { return tasks_.empty(); }
+
+    // Validates stages until none are left to claim
+    void Join(const CoreChecks &validator) {
+        const auto task_count = static_cast<uint32_t>(tasks_.size());
+        for (uint32_t task = next_task_.fetch_add(1); task < task_count; task = next_task_.fetch_add(1)) {
+            {
+                DeferredLogScope deferred_log(messages_[task]);
+                const auto &pipeline = *pipelines_[tasks_[task].first];
+                validator.ValidatePipelineShaderStage(pipeline, pipeline.stage_states[tasks_[task].second],
+                                                      CoreChecks::ShaderStageChecks::kDeferrable);
+            }
+            if (completed_tasks_.fetch_add(1) + 1 == task_count) {
+                for (auto &messages : messages_) {
+                    messages.Emit(validator.report_data);
+                }
+                std::lock_guard<std::mutex> lock(done_mutex_);
+                done_ = true;
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+    // Validates any stages left, then waits for stages claimed by other threads to finish
+    void Finish(const CoreChecks &validator) {
+        Join(validator);
+        std::unique_lock<std::mutex> lock(done_mutex_);
+        done_cv_.wait(lock, [this] { return done_; });
+    }
+
+  private:
+    std::vector<std::shared_ptr<const PIPELINE_STATE>> pipelines_;
+    std::vector<std::pair<uint32_t, uint32_t>> tasks_;  // pipeline index, stage index
+    std::vector<DeferredLogMessages> messages_;
+    std::atomic<uint32_t> next_task_{0};
+    std::atomic<uint32_t> completed_tasks_{0};
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+    bool done_ = false;
+};
+
+void CoreChecks::PreCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkDeferredOperationKHR deferredOperation,
+                                                           VkPipelineCache pipelineCache, uint32_t count,
+                                                           const VkRayTracingPipelineCreateInfoKHR *pCreateInfos,
+                                                           const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                           void *crtpl_state_data) {
+    if (deferredOperation == VK_NULL_HANDLE) {
+        return;
+    }
+    // The operation can only be reused once the earlier operation completed, which the application may have seen from a join
+    // without asking for its result. Validation left of it would otherwise be dropped.
+    FinishDeferredPipelineValidation(deferredOperation);
+
+    auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_khr_api_state *>(crtpl_state_data);
+    std::vector<std::shared_ptr<const PIPELINE_STATE>> pipelines(crtpl_state->pipe_state.begin(), crtpl_state->pipe_state.end());
+    auto deferred_validation = std::make_shared<DeferredPipelineValidation>(std::move(pipelines));
+    if (!deferred_validation->Empty()) {
+        deferred_pipeline_validation_.insert(deferredOperation, std::move(deferred_validation));
+    }
+}
+
+void CoreChecks::PostCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkDeferredOperationKHR deferredOperation,
+                                                            VkPipelineCache pipelineCache, uint32_t count,
+                                                            const VkRayTracingPipelineCreateInfoKHR *pCreateInfos,
+                                                            const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                            VkResult result, void *crtpl_state_data) {
+    // If the driver did not defer the operation, nothing will be joined to it
+    if (deferredOperation != VK_NULL_HANDLE && result != VK_OPERATION_DEFERRED_KHR) {
+        FinishDeferredPipelineValidation(deferredOperation);
+    }
+    StateTracker::PostCallRecordCreateRayTracingPipelinesKHR(device, deferredOperation, pipelineCache, count, pCreateInfos,
+                                                             pAllocator, pPipelines, result, crtpl_state_data);
+}
+
+void CoreChecks::PreCallRecordDeferredOperationJoinKHR(VkDevice device, VkDeferredOperationKHR operation) {
+    // The layer's tasks go ahead of the driver's, the thread then joins the driver's work as usual
+    auto deferred_validation = deferred_pipeline_validation_.find(operation);
+    if (deferred_validation->first) {
+        deferred_validation->second->Join(*this);
+    }
+}
+
+void CoreChecks::PostCallRecordGetDeferredOperationResultKHR(VkDevice device, VkDeferredOperationKHR operation, VkResult result) {
+    // Once the application can see the operation is complete, so must be the validation of it
+    if (result != VK_NOT_READY) {
+        FinishDeferredPipelineValidation(operation);
+    }
+}
+
+void CoreChecks::PreCallRecordDestroyDeferredOperationKHR(VkDevice device, VkDeferredOperationKHR operation,
+                                                          const VkAllocationCallbacks *pAllocator) {
+    FinishDeferredPipelineValidation(operation);
+}
+
+void CoreChecks::FinishDeferredPipelineValidation(VkDeferredOperationKHR operation) {
+    auto deferred_validation = deferred_pipeline_validation_.pop(operation);
+    if (deferred_validation->first) {
+        deferred_validation->second->Finish(*this);
+    }
 }
@@ -2448,7 +2448,35 @@ bool CoreChecks::ValidateImageWrite(const SHADER_MODULE_STATE &module_state) con
     return skip;
 }
 
-bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, const PipelineStageState &stage_state) const {
+// Everything in a pipeline stage that can change the result of applying its specialization constants
+static ValidationCache::Key MakeSpecializedStageKey(const ValidationCache::Key &environment, const SHADER_MODULE_STATE &module_state,
+                                                    const safe_VkPipelineShaderStageCreateInfo &create_info) {
+    const auto &static_data = module_state.static_data_;
+    std::call_once(static_data.content_key_once, [&module_state, &static_data]() {
+        static_data.content_key =
+            ValidationCache::KeyBuilder().Add(module_state.words_.data(), module_state.words_.size() * sizeof(uint32_t)).Get();
+    });
+    ValidationCache::KeyBuilder builder;
+    builder.Add(environment.data(), environment.size() * sizeof(uint32_t));
+    builder.Add(static_data.content_key.data(), static_data.content_key.size() * sizeof(uint32_t));
+    builder.Add(create_info.pName, strlen(create_info.pName));
+    builder.Add(static_cast<uint32_t>(create_info.stage));
+    if (const auto *specialization_info = create_info.pSpecializationInfo) {
+        const uint32_t map_entry_count = specialization_info->pMapEntries ? specialization_info->mapEntryCount : 0;
+        builder.Add(map_entry_count);
+        for (uint32_t i = 0; i < map_entry_count; ++i) {
+            const auto &map_entry = specialization_info->pMapEntries[i];
+            builder.Add(map_entry.constantID);
+            builder.Add(map_entry.offset);
+            builder.Add(static_cast<uint32_t>(map_entry.size));
+        }
+        builder.Add(specialization_info->pData, specialization_info->dataSize);
+    }
+    return builder.Get();
+}
+
+bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, const PipelineStageState &stage_state,
+                                             ShaderStageChecks checks) const {
     bool skip = false;
     const auto *create_info = stage_state.create_info;
     const SHADER_MODULE_STATE &module_state = *stage_state.module_state.get();
@@ -2458,6 +2486,9 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
         return skip;  // these edge cases should be validated already
     }
     if (!stage_state.entrypoint) {
+        if (checks == ShaderStageChecks::kDeferrable) {
+            return skip;  // already reported by the kGating checks
+        }
         return LogError(device, "VUID-VkPipelineShaderStageCreateInfo-pName-00707",
                         "%s(): pCreateInfos[%" PRIu32 "] No entrypoint found named `%s` for stage %s.",
                         pipeline.GetCreateFunctionName(), pipeline.create_index, create_info->pName,
@@ -2472,7 +2503,37 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
     uint32_t total_workgroup_shared_memory = 0;
 
     // If specialization-constant instructions are present in the shader, the specializations should be applied.
+    // Applying them means running spirv-opt and spirv-val over the whole module, so the results of stages that specialized
+    // cleanly are memoized for the device, and kept in the validation cache for later runs, keyed by the module contents and
+    // everything in the stage that affects them.
+    auto *cache = CastFromHandle<ValidationCache *>(core_validation_cache);
+    ValidationCache::SpecializedStage cached_stage{};
+    ValidationCache::Key stage_key{};
+    bool specialized_from_cache = false;
     if (module_state.static_data_.has_specialization_constants) {
+        stage_key = MakeSpecializedStageKey(spirv_environment_key_, module_state, *create_info);
+        if (FindSpecializedStage(stage_key, cached_stage)) {
+            specialized_from_cache = true;
+        } else if (cache && cache->FindSpecializedStage(stage_key, cached_stage)) {
+            InsertSpecializedStage(stage_key, cached_stage);
+            specialized_from_cache = true;
+        }
+        if (specialized_from_cache) {
+            local_size_x = cached_stage.local_size_x;
+            local_size_y = cached_stage.local_size_y;
+            local_size_z = cached_stage.local_size_z;
+            total_workgroup_shared_memory = cached_stage.workgroup_shared_memory;
+        } else if (checks == ShaderStageChecks::kDeferrable) {
+            // The kGating checks memoize the stage when it specializes cleanly. Otherwise they already reported why it didn't, and
+            // the remaining checks would only produce false positives.
+            return skip;
+        }
+    }
+
+    if (module_state.static_data_.has_specialization_constants && !specialized_from_cache) {
+        // Tracked separately from skip, as a filtered message must not make the stage look valid to the cache
+        bool specialization_valid = true;
+
         // both spirv-opt and spirv-val will use the same flags
         spvtools::ValidatorOptions options;
         AdjustValidatorOptions(device_extensions, enabled_features, options);
@@ -2480,9 +2541,10 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
         // setup the call back if the optimizer fails
         spv_target_env spirv_environment = PickSpirvEnv(api_version, IsExtEnabled(device_extensions.vk_khr_spirv_1_4));
         spvtools::Optimizer optimizer(spirv_environment);
-        spvtools::MessageConsumer consumer = [&skip, &module_state, &stage, &pipeline, this](
+        spvtools::MessageConsumer consumer = [&skip, &specialization_valid, &module_state, &stage, &pipeline, this](
                                                  spv_message_level_t level, const char *source, const spv_position_t &position,
                                                  const char *message) {
+            specialization_valid = false;
             skip |= LogError(device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter",
                              "%s(): pCreateInfos[%" PRIu32 "] %s does not contain valid spirv for stage %s. %s",
                              pipeline.GetCreateFunctionName(), pipeline.create_index,
@@ -2528,6 +2590,7 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
                     }
 
                     if (map_entry.size != spec_const_size) {
+                        specialization_valid = false;
                         skip |= LogError(
                             device, "VUID-VkSpecializationMapEntry-constantID-00776",
                             "%s(): pCreateInfos[%" PRIu32 "] Specialization constant (ID = %" PRIu32 ", entry = %" PRIu32
@@ -2581,6 +2644,7 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
             spv_diagnostic diag = nullptr;
             auto const spv_valid = spvValidateWithOptions(ctx, options, &binary, &diag);
             if (spv_valid != SPV_SUCCESS) {
+                specialization_valid = false;
                 skip |= LogError(device, pSpecializationInfo_vuid,
                                  "%s(): pCreateInfos[%" PRIu32
                                  "] After specialization was applied, %s does not contain valid spirv for stage %s.",
@@ -2610,6 +2674,7 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
             spvContextDestroy(ctx);
         } else {
             // Should never get here, but better then asserting
+            specialization_valid = false;
             skip |=
                 LogError(device, pSpecializationInfo_vuid,
                          "%s(): pCreateInfos[%" PRIu32
@@ -2618,10 +2683,23 @@ bool CoreChecks::ValidatePipelineShaderStage(const PIPELINE_STATE &pipeline, con
                          report_data->FormatHandle(module_state.vk_shader_module()).c_str(), string_VkShaderStageFlagBits(stage));
         }
 
+        // Stages that failed are not recorded, their errors have to be reported for every pipeline they are used in
+        if (specialization_valid) {
+            const ValidationCache::SpecializedStage specialized_stage{local_size_x, local_size_y, local_size_z,
+                                                                      total_workgroup_shared_memory};
+            InsertSpecializedStage(stage_key, specialized_stage);
+            if (cache) {
+                cache->InsertSpecializedStage(stage_key, specialized_stage);
+            }
+        }
+
         if (skip) {
             return skip;  // if spec constants have errors, can produce false positives later
         }
     }
+    if (checks == ShaderStageChecks::kGating) {
+        return skip;
+    }
 
     // Validate descriptor set layout against what the entrypoint actually uses
 
@@ -2979,7 +3057,132 @@ bool CoreChecks::GroupHasValidIndex(const PIPELINE_STATE &pipeline, uint32_t gro
     return false;
 }
 
-uint32_t ValidationCache::MakeShaderHash(VkShaderModuleCreateInfo const *smci) { return XXH32(smci->pCode, smci->codeSize, 0); }
+static constexpr std::array<uint32_t, std::tuple_size<ValidationCache::Key>::value> kValidationCacheSeeds = {
+    0x00000000, 0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D};
+
+ValidationCache::KeyBuilder &ValidationCache::KeyBuilder::Add(const void *data, size_t size) {
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        lanes_[lane].push_back(XXH32(data, size, kValidationCacheSeeds[lane]));
+        lanes_[lane].push_back(static_cast<uint32_t>(size));
+    }
+    return *this;
+}
+
+ValidationCache::Key ValidationCache::KeyBuilder::Get() const {
+    Key key;
+    for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        key[lane] = XXH32(lanes_[lane].data(), lanes_[lane].size() * sizeof(uint32_t), kValidationCacheSeeds[lane]);
+    }
+    return key;
+}
+
+ValidationCache::Key ValidationCache::MakeShaderKey(VkShaderModuleCreateInfo const *smci, const Key &environment) {
+    return KeyBuilder().Add(environment.data(), sizeof(Key)).Add(smci->pCode, smci->codeSize).Get();
+}
+
+void ValidationCache::Load(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
+    const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;
+    if (!pCreateInfo->pInitialData || pCreateInfo->initialDataSize < headerSize) return;
+
+    uint32_t const *data = (uint32_t const *)pCreateInfo->pInitialData;
+    if (data[0] != headerSize) return;
+    if (data[1] != VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT) return;
+    uint8_t expected_uuid[VK_UUID_SIZE];
+    Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, expected_uuid);
+    if (memcmp(&data[2], expected_uuid, VK_UUID_SIZE) != 0) return;  // different version
+
+    // Anything that doesn't exactly match the layout written by Write, or fails the checksum, is ignored as a whole
+    const uint32_t *words = reinterpret_cast<uint32_t const *>(reinterpret_cast<uint8_t const *>(data) + headerSize);
+    const size_t word_count = (pCreateInfo->initialDataSize - headerSize) / sizeof(uint32_t);
+    const size_t key_words = std::tuple_size<Key>::value;
+    const size_t stage_words = key_words + sizeof(SpecializedStage) / sizeof(uint32_t);
+    if (word_count < 5 || words[0] != kDataMagic || words[1] != kDataVersion) return;
+    const size_t module_count = words[2];
+    const size_t stage_count = words[3];
+    const size_t expected_count = 4 + module_count * key_words + stage_count * stage_words + 1;
+    if (word_count != expected_count) return;
+    if (XXH32(words, (expected_count - 1) * sizeof(uint32_t), 0) != words[expected_count - 1]) return;
+
+    auto guard = WriteLock();
+    const uint32_t *pos = words + 4;
+    good_shader_keys_.reserve(good_shader_keys_.size() + module_count);
+    for (size_t i = 0; i < module_count; ++i, pos += key_words) {
+        Key key;
+        std::copy(pos, pos + key_words, key.begin());
+        good_shader_keys_.insert(key);
+    }
+    for (size_t i = 0; i < stage_count; ++i, pos += stage_words) {
+        Key key;
+        std::copy(pos, pos + key_words, key.begin());
+        SpecializedStage stage;
+        std::memcpy(&stage, pos + key_words, sizeof(SpecializedStage));
+        specialized_stages_.Insert(key, stage);
+    }
+}
+
+void ValidationCache::Write(size_t *pDataSize, void *pData) {
+    const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;  // 4 bytes for header size + 4 bytes for version number + UUID
+
+    // The data is all or nothing, as a truncated copy would fail the integrity check
+    std::vector<uint32_t> words;
+    {
+        auto guard = ReadLock();
+        words.reserve(5 + good_shader_keys_.size() * std::tuple_size<Key>::value +
+                      specialized_stages_.size() * (sizeof(Key) + sizeof(SpecializedStage)) / sizeof(uint32_t));
+        words.push_back(kDataMagic);
+        words.push_back(kDataVersion);
+        words.push_back(static_cast<uint32_t>(good_shader_keys_.size()));
+        words.push_back(static_cast<uint32_t>(specialized_stages_.size()));
+        for (const auto &key : good_shader_keys_) {
+            words.insert(words.end(), key.begin(), key.end());
+        }
+        specialized_stages_.ForEach([&words](const Key &key, const SpecializedStage &stage) {
+            words.insert(words.end(), key.begin(), key.end());
+            const auto *stage_words = reinterpret_cast<const uint32_t *>(&stage);
+            words.insert(words.end(), stage_words, stage_words + sizeof(SpecializedStage) / sizeof(uint32_t));
+        });
+    }
+    words.push_back(XXH32(words.data(), words.size() * sizeof(uint32_t), 0));
+
+    const size_t data_size = headerSize + words.size() * sizeof(uint32_t);
+    if (!pData) {
+        *pDataSize = data_size;
+        return;
+    }
+
+    if (*pDataSize < headerSize) {
+        *pDataSize = 0;
+        return;  // Too small for even the header!
+    }
+
+    uint32_t *out = (uint32_t *)pData;
+
+    // Write the header
+    *out++ = headerSize;
+    *out++ = VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT;
+    Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, reinterpret_cast<uint8_t *>(out));
+    out = (uint32_t *)(reinterpret_cast<uint8_t *>(out) + VK_UUID_SIZE);
+
+    if (*pDataSize < data_size) {
+        *pDataSize = headerSize;
+        return;
+    }
+    std::copy(words.begin(), words.end(), out);
+    *pDataSize = data_size;
+}
+
+void ValidationCache::Merge(ValidationCache const *other) {
+    // self-merging is invalid, but avoid deadlock below just in case.
+    if (other == this) {
+        return;
+    }
+    auto other_guard = other->ReadLock();
+    auto guard = WriteLock();
+    good_shader_keys_.reserve(good_shader_keys_.size() + other->good_shader_keys_.size());
+    for (const auto &key : other->good_shader_keys_) good_shader_keys_.insert(key);
+    other->specialized_stages_.ForEach(
+        [this](const Key &key, const SpecializedStage &stage) { specialized_stages_.Insert(key, stage); });
+}
 
 static ValidationCache *GetValidationCacheInfo(VkShaderModuleCreateInfo const *pCreateInfo) {
     const auto validation_cache_ci = LvlFindInChain<VkShaderModuleValidationCacheCreateInfoEXT>(pCreateInfo->pNext);
@@ -3005,17 +3208,17 @@ bool CoreChecks::PreCallValidateCreateShaderModule(VkDevice device, const VkShad
                          "SPIR-V module not valid: Codesize must be a multiple of 4 but is %zu", pCreateInfo->codeSize);
     } else {
         auto cache = GetValidationCacheInfo(pCreateInfo);
-        uint32_t hash = 0;
+        ValidationCache::Key key{};
+        spv_target_env spirv_environment = PickSpirvEnv(api_version, IsExtEnabled(device_extensions.vk_khr_spirv_1_4));
         // If app isn't using a shader validation cache, use the default one from CoreChecks
         if (!cache) cache = CastFromHandle<ValidationCache *>(core_validation_cache);
         if (cache) {
-            hash = ValidationCache::MakeShaderHash(pCreateInfo);
-            if (cache->Contains(hash)) return false;
+            key = ValidationCache::MakeShaderKey(pCreateInfo, spirv_environment_key_);
+            if (cache->Contains(key)) return false;
         }
 
         // Use SPIRV-Tools validator to try and catch any issues with the module itself. If specialization constants are present,
         // the default values will be used during validation.
-        spv_target_env spirv_environment = PickSpirvEnv(api_version, IsExtEnabled(device_extensions.vk_khr_spirv_1_4));
         spv_context ctx = spvContextCreate(spirv_environment);
         spv_const_binary_t binary{pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)};
         spv_diagnostic diag = nullptr;
@@ -3034,7 +3237,7 @@ bool CoreChecks::PreCallValidateCreateShaderModule(VkDevice device, const VkShad
             }
         } else {
             if (cache) {
-                cache->Insert(hash);
+                cache->Insert(key);
             }
         }
 
@@ -3345,3 +3548,17 @@ void AdjustValidatorOptions(const DeviceExtensions &device_extensions, const Dev
     // Faster validation without friendly names.
     options.SetFriendlyNames(false);
 }
+
+ValidationCache::Key MakeValidationEnvironmentKey(spv_target_env spirv_environment, const DeviceExtensions &device_extensions,
+                                                  const DeviceFeatures &enabled_features) {
+    // Must cover every input of AdjustValidatorOptions
+    const uint32_t environment[] = {
+        static_cast<uint32_t>(spirv_environment),
+        IsExtEnabled(device_extensions.vk_khr_relaxed_block_layout) ? 1u : 0u,
+        enabled_features.core12.uniformBufferStandardLayout,
+        enabled_features.core12.scalarBlockLayout,
+        enabled_features.workgroup_memory_explicit_layout_features.workgroupMemoryExplicitLayoutScalarBlockLayout,
+        enabled_features.core13.maintenance4,
+    };
+    return ValidationCache::KeyBuilder().Add(environment, sizeof(environment)).Get();
+}
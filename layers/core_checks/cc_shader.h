@@ -20,7 +20,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstdlib>
+#include <deque>
+#include <vector>
 
 #include "vulkan/vulkan.h"
 #include <generated/spirv_tools_commit_id.h>
@@ -32,88 +35,106 @@ struct DeviceExtensions;
 
 class ValidationCache {
   public:
-    static VkValidationCacheEXT Create(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
-        auto cache = new ValidationCache();
-        cache->Load(pCreateInfo);
-        return VkValidationCacheEXT(cache);
-    }
-
-    void Load(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
-        const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;
-        auto size = headerSize;
-        if (!pCreateInfo->pInitialData || pCreateInfo->initialDataSize < size) return;
-
-        uint32_t const *data = (uint32_t const *)pCreateInfo->pInitialData;
-        if (data[0] != size) return;
-        if (data[1] != VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT) return;
-        uint8_t expected_uuid[VK_UUID_SIZE];
-        Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, expected_uuid);
-        if (memcmp(&data[2], expected_uuid, VK_UUID_SIZE) != 0) return;  // different version
-
-        data = (uint32_t const *)(reinterpret_cast<uint8_t const *>(data) + headerSize);
-
-        auto guard = WriteLock();
-        for (; size < pCreateInfo->initialDataSize; data++, size += sizeof(uint32_t)) {
-            good_shader_hashes_.insert(*data);
+    // 128 bit content key. The 64 bit XXH variants are disabled in this build (XXH_NO_LONG_LONG), so keys are made of four
+    // differently seeded XXH32 streams.
+    using Key = std::array<uint32_t, 4>;
+    struct KeyHash {
+        size_t operator()(const Key &key) const { return key[0]; }
+    };
+    class KeyBuilder {
+      public:
+        KeyBuilder &Add(const void *data, size_t size);
+        KeyBuilder &Add(uint32_t value) { return Add(&value, sizeof(value)); }
+        Key Get() const;
+
+      private:
+        std::array<std::vector<uint32_t>, std::tuple_size<Key>::value> lanes_;
+    };
+
+    // Results derived from a shader stage after specialization constants are applied, recorded only if it was valid.
+    struct SpecializedStage {
+        uint32_t local_size_x;
+        uint32_t local_size_y;
+        uint32_t local_size_z;
+        uint32_t workgroup_shared_memory;
+    };
+
+    // Specialized stages by key, up to kMaxEntries of them. Once full, the oldest entry is evicted for each new one, as apps
+    // that keep generating specializations would otherwise grow the table, and the serialized cache, forever. Not
+    // synchronized.
+    class SpecializedStageMap {
+      public:
+        // About 1MB once serialized
+        static constexpr size_t kMaxEntries = 32 * 1024;
+
+        bool Find(const Key &key, SpecializedStage &stage) const {
+            auto it = stages_.find(key);
+            if (it == stages_.end()) return false;
+            stage = it->second;
+            return true;
         }
-    }
 
-    void Write(size_t *pDataSize, void *pData) {
-        const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;  // 4 bytes for header size + 4 bytes for version number + UUID
-        if (!pData) {
-            *pDataSize = headerSize + good_shader_hashes_.size() * sizeof(uint32_t);
-            return;
+        void Insert(const Key &key, const SpecializedStage &stage) {
+            if (!stages_.emplace(key, stage).second) return;
+            order_.push_back(key);
+            if (order_.size() > kMaxEntries) {
+                stages_.erase(order_.front());
+                order_.pop_front();
+            }
         }
 
-        if (*pDataSize < headerSize) {
-            *pDataSize = 0;
-            return;  // Too small for even the header!
+        size_t size() const { return order_.size(); }
+
+        // Calls f(key, stage) from the oldest entry to the newest
+        template <typename F>
+        void ForEach(F &&f) const {
+            for (const auto &key : order_) {
+                f(key, stages_.find(key)->second);
+            }
         }
 
-        uint32_t *out = (uint32_t *)pData;
-        size_t actualSize = headerSize;
+      private:
+        vvl::unordered_map<Key, SpecializedStage, KeyHash> stages_;
+        std::deque<Key> order_;
+    };
 
-        // Write the header
-        *out++ = headerSize;
-        *out++ = VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT;
-        Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, reinterpret_cast<uint8_t *>(out));
-        out = (uint32_t *)(reinterpret_cast<uint8_t *>(out) + VK_UUID_SIZE);
+    static VkValidationCacheEXT Create(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
+        auto cache = new ValidationCache();
+        cache->Load(pCreateInfo);
+        return VkValidationCacheEXT(cache);
+    }
 
-        {
-            auto guard = ReadLock();
-            for (auto it = good_shader_hashes_.begin(); it != good_shader_hashes_.end() && actualSize < *pDataSize;
-                 it++, out++, actualSize += sizeof(uint32_t)) {
-                *out = *it;
-            }
-        }
+    void Load(VkValidationCacheCreateInfoEXT const *pCreateInfo);
+    void Write(size_t *pDataSize, void *pData);
+    void Merge(ValidationCache const *other);
+
+    static Key MakeShaderKey(VkShaderModuleCreateInfo const *smci, const Key &environment);
 
-        *pDataSize = actualSize;
+    bool Contains(const Key &key) {
+        auto guard = ReadLock();
+        return good_shader_keys_.count(key) != 0;
     }
 
-    void Merge(ValidationCache const *other) {
-        // self-merging is invalid, but avoid deadlock below just in case.
-        if (other == this) {
-            return;
-        }
-        auto other_guard = other->ReadLock();
+    void Insert(const Key &key) {
         auto guard = WriteLock();
-        good_shader_hashes_.reserve(good_shader_hashes_.size() + other->good_shader_hashes_.size());
-        for (auto h : other->good_shader_hashes_) good_shader_hashes_.insert(h);
+        good_shader_keys_.insert(key);
     }
 
-    static uint32_t MakeShaderHash(VkShaderModuleCreateInfo const *smci);
-
-    bool Contains(uint32_t hash) {
+    bool FindSpecializedStage(const Key &key, SpecializedStage &stage) const {
         auto guard = ReadLock();
-        return good_shader_hashes_.count(hash) != 0;
+        return specialized_stages_.Find(key, stage);
     }
 
-    void Insert(uint32_t hash) {
+    void InsertSpecializedStage(const Key &key, const SpecializedStage &stage) {
         auto guard = WriteLock();
-        good_shader_hashes_.insert(hash);
+        specialized_stages_.Insert(key, stage);
     }
 
   private:
+    // Layout of the data following the VkValidationCacheHeaderVersionOneEXT header
+    static constexpr uint32_t kDataMagic = 0x434C5656;  // "VVLC"
+    static constexpr uint32_t kDataVersion = 2;
+
     ValidationCache() {}
     ReadLockGuard ReadLock() const { return ReadLockGuard(lock_); }
     WriteLockGuard WriteLock() { return WriteLockGuard(lock_); }
@@ -137,11 +158,14 @@ class ValidationCache {
         }
     }
 
-    // hashes of shaders that have passed validation before, and can be skipped.
+    // keys of shaders that have passed validation before, and can be skipped.
     // we don't store negative results, as we would have to also store what was
     // wrong with them; also, we expect they will get fixed, so we're less
     // likely to see them again.
-    vvl::unordered_set<uint32_t> good_shader_hashes_;
+    vvl::unordered_set<Key, KeyHash> good_shader_keys_;
+    // keys of (module, entry point, specialization info, validation environment) that were valid after specialization. Written
+    // from the oldest to the newest, so the eviction order survives a save and load.
+    SpecializedStageMap specialized_stages_;
     mutable std::shared_mutex lock_;
 };
 
@@ -149,4 +173,6 @@ spv_target_env PickSpirvEnv(uint32_t api_version, bool spirv_1_4);
 
 void AdjustValidatorOptions(const DeviceExtensions &device_extensions, const DeviceFeatures &enabled_features,
                             spvtools::ValidatorOptions &options);
+ValidationCache::Key MakeValidationEnvironmentKey(spv_target_env spirv_environment, const DeviceExtensions &device_extensions,
+                                                  const DeviceFeatures &enabled_features);
 
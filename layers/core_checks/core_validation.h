@@ -262,6 +262,7 @@ struct TimelineMaxDiffCheck {
 };
 
 class CoreChecks;
+class DeferredPipelineValidation;
 struct SemaphoreSubmitState {
     const CoreChecks* core;
     VkQueue queue;
@@ -363,6 +364,24 @@ class CoreChecks : public ValidationStateTracker {
     GlobalQFOTransferBarrierMap<QFOBufferTransferBarrier> qfo_release_buffer_barrier_map;
     VkValidationCacheEXT core_validation_cache = VK_NULL_HANDLE;
     std::string validation_cache_path;
+    bool report_shader_module_stats_ = false;
+    // Validation environment (SPIR-V target environment, extensions and features) part of the shader validation keys
+    ValidationCache::Key spirv_environment_key_{};
+    // Results of pipeline stages that specialized cleanly, for the lifetime of the device or until evicted. Unlike the ones kept
+    // in core_validation_cache, they are there even when shader validation caching is disabled.
+    mutable ValidationCache::SpecializedStageMap specialized_stages_;
+    mutable std::shared_mutex specialized_stages_lock_;
+    bool FindSpecializedStage(const ValidationCache::Key &key, ValidationCache::SpecializedStage &stage) const {
+        ReadLockGuard guard(specialized_stages_lock_);
+        return specialized_stages_.Find(key, stage);
+    }
+    void InsertSpecializedStage(const ValidationCache::Key &key, const ValidationCache::SpecializedStage &stage) const {
+        WriteLockGuard guard(specialized_stages_lock_);
+        specialized_stages_.Insert(key, stage);
+    }
+    // Shader stage validation of vkCreateRayTracingPipelinesKHR calls made with a deferred operation, run by the threads the
+    // application joins to the operation
+    vl_concurrent_unordered_map<VkDeferredOperationKHR, std::shared_ptr<DeferredPipelineValidation>> deferred_pipeline_validation_;
 
     CoreChecks() { container_type = LayerObjectTypeCoreValidation; }
 
@@ -856,14 +875,19 @@ class CoreChecks : public ValidationStateTracker {
     uint32_t CalcShaderStageCount(const PIPELINE_STATE& pipeline, VkShaderStageFlagBits stageBit) const;
     bool GroupHasValidIndex(const PIPELINE_STATE& pipeline, uint32_t group, uint32_t stage) const;
     bool ValidateRayTracingPipeline(const PIPELINE_STATE& pipeline, const safe_VkRayTracingPipelineCreateInfoCommon& create_info,
-                                    VkPipelineCreateFlags flags, bool isKHR) const;
+                                    VkPipelineCreateFlags flags, bool isKHR, bool validate_stages = true) const;
     bool PreCallValidateGetShaderModuleIdentifierEXT(VkDevice device, VkShaderModule shaderModule,
                                                      VkShaderModuleIdentifierEXT* pIdentifier) const override;
     bool PreCallValidateGetShaderModuleCreateInfoIdentifierEXT(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
                                                                VkShaderModuleIdentifierEXT* pIdentifier) const override;
     bool PreCallValidateCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
                                            const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule) const override;
-    bool ValidatePipelineShaderStage(const PIPELINE_STATE& pipeline, const PipelineStageState& stage_state) const;
+    // The checks of a shader stage that must be able to fail the call (the entrypoint and applying the specialization constants)
+    // are kGating, the rest are kDeferrable, which are left to the threads joining a deferred operation. kDeferrable relies on the
+    // kGating checks having run first, and only reads the memoized result of the specialization.
+    enum class ShaderStageChecks { kAll, kGating, kDeferrable };
+    bool ValidatePipelineShaderStage(const PIPELINE_STATE& pipeline, const PipelineStageState& stage_state,
+                                     ShaderStageChecks checks = ShaderStageChecks::kAll) const;
     bool ValidatePointSizeShaderState(const PIPELINE_STATE& pipeline, const SHADER_MODULE_STATE& module_state,
                                       const EntryPoint& entrypoint, VkShaderStageFlagBits stage) const;
     bool ValidatePrimitiveRateShaderState(const PIPELINE_STATE& pipeline, const SHADER_MODULE_STATE& module_state,
@@ -1353,6 +1377,21 @@ class CoreChecks : public ValidationStateTracker {
                                                      const VkRayTracingPipelineCreateInfoKHR* pCreateInfos,
                                                      const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
                                                      void* pipe_state) const override;
+    void PreCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkDeferredOperationKHR deferredOperation,
+                                                   VkPipelineCache pipelineCache, uint32_t count,
+                                                   const VkRayTracingPipelineCreateInfoKHR* pCreateInfos,
+                                                   const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
+                                                   void* pipe_state) override;
+    void PostCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkDeferredOperationKHR deferredOperation,
+                                                    VkPipelineCache pipelineCache, uint32_t count,
+                                                    const VkRayTracingPipelineCreateInfoKHR* pCreateInfos,
+                                                    const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
+                                                    VkResult result, void* pipe_state) override;
+    void PreCallRecordDeferredOperationJoinKHR(VkDevice device, VkDeferredOperationKHR operation) override;
+    void PostCallRecordGetDeferredOperationResultKHR(VkDevice device, VkDeferredOperationKHR operation, VkResult result) override;
+    void PreCallRecordDestroyDeferredOperationKHR(VkDevice device, VkDeferredOperationKHR operation,
+                                                  const VkAllocationCallbacks* pAllocator) override;
+    void FinishDeferredPipelineValidation(VkDeferredOperationKHR operation);
     bool PreCallValidateCmdTraceRaysNV(VkCommandBuffer commandBuffer, VkBuffer raygenShaderBindingTableBuffer,
                                        VkDeviceSize raygenShaderBindingOffset, VkBuffer missShaderBindingTableBuffer,
                                        VkDeviceSize missShaderBindingOffset, VkDeviceSize missShaderBindingStride,
@@ -316,9 +316,11 @@ VKAPI_ATTR void DeactivateInstanceDebugCallbacks(debug_report_data *debug_data)
 }
 
 // helper for VUID based filtering. This needs to be separate so it can be called before incurring
-// the cost of sprintf()-ing the err_msg needed by LogMsgLocked().
+// the cost of sprintf()-ing the err_msg needed by LogMsgLocked(). Messages are only counted against the duplicate message limit
+// if count_duplicates is set.
 static bool LogMsgEnabled(const debug_report_data *debug_data, std::string_view vuid_text,
-                          VkDebugUtilsMessageSeverityFlagsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type) {
+                          VkDebugUtilsMessageSeverityFlagsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type,
+                          bool count_duplicates = true) {
     if (!(debug_data->active_severities & severity) || !(debug_data->active_types & type)) {
         return false;
     }
@@ -328,13 +330,33 @@ static bool LogMsgEnabled(const debug_report_data *debug_data, std::string_view
         != debug_data->filter_message_ids.end()) {
         return false;
     }
-    if ((debug_data->duplicate_message_limit > 0) && UpdateLogMsgCounts(debug_data, static_cast<int32_t>(message_id))) {
+    if (count_duplicates && (debug_data->duplicate_message_limit > 0) &&
+        UpdateLogMsgCounts(debug_data, static_cast<int32_t>(message_id))) {
         // Count for this particular message is over the limit, ignore it
         return false;
     }
     return true;
 }
 
+// Whether a message that passed LogMsgEnabled reaches a callback that could ask to bail, which is what debug_log_msg would return
+// for it if the callback does. The layer's default callbacks never ask to bail.
+static bool LogMsgMayBail(const debug_report_data *debug_data, VkFlags msg_flags, VkDebugUtilsMessageSeverityFlagsEXT severity,
+                          VkDebugUtilsMessageTypeFlagsEXT type) {
+    for (const auto &current_callback : debug_data->debug_callback_list) {
+        if (current_callback.IsDefault()) {
+            continue;
+        }
+        if (current_callback.IsUtils()) {
+            if ((current_callback.debug_utils_msg_flags & severity) && (current_callback.debug_utils_msg_type & type)) {
+                return true;
+            }
+        } else if (current_callback.debug_report_msg_flags & msg_flags) {
+            return true;
+        }
+    }
+    return false;
+}
+
 VKAPI_ATTR bool LogMsg(const debug_report_data *debug_data, VkFlags msg_flags, const LogObjectList &objects,
                        std::string_view vuid_text, const char *format, va_list argptr) {
     assert(*(vuid_text.data() + vuid_text.size()) == '\0');
@@ -343,11 +365,18 @@ VKAPI_ATTR bool LogMsg(const debug_report_data *debug_data, VkFlags msg_flags, c
     VkDebugUtilsMessageTypeFlagsEXT type;
 
     DebugReportFlagsToAnnotFlags(msg_flags, &severity, &type);
+    auto *deferred = DeferredLogScope::Current();
     std::unique_lock<std::mutex> lock(debug_data->debug_output_mutex);
-    // Avoid logging cost if msg is to be ignored
-    if (!LogMsgEnabled(debug_data, vuid_text, severity, type)) {
+    // Avoid logging cost if msg is to be ignored. Deferred messages are counted when they are emitted, in serial order.
+    if (!LogMsgEnabled(debug_data, vuid_text, severity, type, !deferred)) {
         return false;
     }
+    // Validation of deferred messages goes on before any callback sees them, so whether they bail is decided up front. That keeps
+    // the "if (skip) return" early outs of the validation working the same as when the message is logged right away.
+    const bool deferred_bail = deferred && LogMsgMayBail(debug_data, msg_flags, severity, type);
+    if (deferred) {
+        lock.unlock();
+    }
 
     // Best guess at an upper bound for message length. At least some of the extra space
     // should get used to store the VUID URL and text in the common case, without additional allocations.
@@ -434,9 +463,38 @@ VKAPI_ATTR bool LogMsg(const debug_report_data *debug_data, VkFlags msg_flags, c
         }
     }
 
+    if (deferred) {
+        deferred->messages_.emplace_back(
+            DeferredLogMessages::Message{msg_flags, objects, std::string(vuid_text), std::move(str_plus_spec_text)});
+        return deferred_bail;
+    }
+
     return debug_log_msg(debug_data, msg_flags, objects, "Validation", str_plus_spec_text.c_str(), vuid_text.data());
 }
 
+thread_local DeferredLogMessages *DeferredLogScope::current_ = nullptr;
+
+bool DeferredLogMessages::Emit(const debug_report_data *debug_data) {
+    bool bail = skip_;
+    skip_ = false;
+    if (messages_.empty()) {
+        return bail;
+    }
+    std::unique_lock<std::mutex> lock(debug_data->debug_output_mutex);
+    for (const auto &message : messages_) {
+        VkDebugUtilsMessageSeverityFlagsEXT severity;
+        VkDebugUtilsMessageTypeFlagsEXT type;
+        DebugReportFlagsToAnnotFlags(message.msg_flags, &severity, &type);
+        if (!LogMsgEnabled(debug_data, message.vuid_text, severity, type)) {
+            continue;
+        }
+        bail |= debug_log_msg(debug_data, message.msg_flags, message.objects, "Validation", message.text.c_str(),
+                              message.vuid_text.c_str());
+    }
+    messages_.clear();
+    return bail;
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL MessengerBreakCallback([[maybe_unused]] VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
                                                       [[maybe_unused]] VkDebugUtilsMessageTypeFlagsEXT message_type,
                                                       [[maybe_unused]] const VkDebugUtilsMessengerCallbackDataEXT *callback_data,
@@ -302,6 +302,46 @@ static inline LogMessageTypeFlags DebugAnnotFlagsToMsgTypeFlags(VkDebugUtilsMess
 VKAPI_ATTR bool LogMsg(const debug_report_data *debug_data, VkFlags msg_flags, const LogObjectList &objects,
                        std::string_view vuid_text, const char *format, va_list argptr);
 
+// Messages logged on a thread while a DeferredLogScope is active are formatted but held back from the callbacks, and only reported
+// when Emit() is called. This lets validation split across worker threads report in the same order it would serially. Message
+// filtering and the duplicate message limit are applied by Emit(), so that they also see the messages in serial order.
+class DeferredLogMessages {
+  public:
+    // Records the skip result of the deferred validation. Messages logged while deferred count as bailing when they reach a
+    // callback other than the layer's default ones, as the callbacks themselves are only called once they are emitted.
+    void MergeSkip(bool skip) { skip_ |= skip; }
+    // Passes the held messages to the callbacks in the order they were logged. Returns the merged skip result, or true if any
+    // callback asked to bail.
+    bool Emit(const debug_report_data *debug_data);
+    bool Empty() const { return messages_.empty(); }
+
+  private:
+    friend VKAPI_ATTR bool LogMsg(const debug_report_data *debug_data, VkFlags msg_flags, const LogObjectList &objects,
+                                  std::string_view vuid_text, const char *format, va_list argptr);
+    struct Message {
+        VkFlags msg_flags;
+        LogObjectList objects;
+        std::string vuid_text;
+        std::string text;
+    };
+    std::vector<Message> messages_;
+    bool skip_ = false;
+};
+
+class DeferredLogScope {
+  public:
+    explicit DeferredLogScope(DeferredLogMessages &messages) : previous_(current_) { current_ = &messages; }
+    ~DeferredLogScope() { current_ = previous_; }
+    DeferredLogScope(const DeferredLogScope &) = delete;
+    DeferredLogScope &operator=(const DeferredLogScope &) = delete;
+
+    static DeferredLogMessages *Current() { return current_; }
+
+  private:
+    static thread_local DeferredLogMessages *current_;
+    DeferredLogMessages *previous_;
+};
+
 VKAPI_ATTR VkResult LayerCreateMessengerCallback(debug_report_data *debug_data, bool default_callback,
                                                  const VkDebugUtilsMessengerCreateInfoEXT *create_info,
                                                  VkDebugUtilsMessengerEXT *messenger);
@@ -42,6 +42,16 @@ void DebugPrintf::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
     use_stdout = !stdout_string.compare("true");
     if (getenv("DEBUG_PRINTF_TO_STDOUT")) use_stdout = true;
 
+    const std::string log_file = GetLayerOptionOrEnvVar("khronos_validation.printf_log_file");
+    if (!log_file.empty()) {
+        printf_log = DebugPrintfLog::Open(log_file);
+        if (printf_log) {
+            printf_log_device_id = printf_log->AddDevice();
+        } else {
+            ReportSetupProblem(device, "Unable to open the Debug Printf log file. Debug Printf messages are reported instead.");
+        }
+    }
+
     // GpuAssistedBase::CreateDevice will set up bindings
     VkDescriptorSetLayoutBinding binding = {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
                                             VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_MESH_BIT_EXT |
@@ -73,9 +83,17 @@ void DebugPrintf::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
     }
 }
 
-// Free the device memory and descriptor set associated with a command buffer.
+void DebugPrintf::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    GpuAssistedBase::PreCallRecordDestroyDevice(device, pAllocator);
+    // The file is closed with the last device logging to it
+    if (printf_log) {
+        printf_log->RemoveDevice(printf_log_device_id);
+        printf_log.reset();
+    }
+}
+
+// Free the descriptor set associated with a command buffer. The output block is released with the arena of the command buffer.
 void DebugPrintf::DestroyBuffer(DPFBufferInfo &buffer_info) {
-    vmaDestroyBuffer(vmaAllocator, buffer_info.output_mem_block.buffer, buffer_info.output_mem_block.allocation);
     if (buffer_info.desc_set != VK_NULL_HANDLE) {
         desc_set_manager->PutBackDescriptorSet(buffer_info.desc_pool, buffer_info.desc_set);
     }
@@ -83,15 +101,10 @@ void DebugPrintf::DestroyBuffer(DPFBufferInfo &buffer_info) {
 
 // Call the SPIR-V Optimizer to run the instrumentation pass on the shader.
 bool DebugPrintf::InstrumentShader(const vvl::span<const uint32_t> &input, std::vector<uint32_t> &new_pgm,
-                                   uint32_t *unique_shader_id) {
+                                   uint32_t unique_shader_id) {
     if (aborted) return false;
     if (input[0] != spv::MagicNumber) return false;
 
-    // Load original shader SPIR-V
-    new_pgm.clear();
-    new_pgm.reserve(input.size());
-    new_pgm.insert(new_pgm.end(), &input.front(), &input.back() + 1);
-
     // Call the optimizer to instrument the shader.
     // Use the unique_shader_module_id as a shader ID so we can look up its handle later in the shader_map.
     // If descriptor indexing is enabled, enable length checks and updated descriptor checks
@@ -102,7 +115,6 @@ bool DebugPrintf::InstrumentShader(const vvl::span<const uint32_t> &input, std::
     spvtools::OptimizerOptions opt_options;
     opt_options.set_run_validator(true);
     opt_options.set_validator_options(val_options);
-    Optimizer optimizer(target_env);
     const spvtools::MessageConsumer debug_printf_console_message_consumer =
         [this](spv_message_level_t level, const char *, const spv_position_t &position, const char *message) -> void {
         switch (level) {
@@ -116,26 +128,27 @@ bool DebugPrintf::InstrumentShader(const vvl::span<const uint32_t> &input, std::
                 break;
         }
     };
-    optimizer.SetMessageConsumer(debug_printf_console_message_consumer);
-    optimizer.RegisterPass(CreateInstDebugPrintfPass(desc_set_bind_index, unique_shader_module_id));
-    const bool pass = optimizer.Run(new_pgm.data(), new_pgm.size(), &new_pgm, opt_options);
-    if (!pass) {
-        ReportSetupProblem(device, "Failure to instrument shader.  Proceeding with non-instrumented shader.");
-    }
-    *unique_shader_id = unique_shader_module_id++;
-    return pass;
-}
-// Create the instrumented shader data to provide to the driver.
-void DebugPrintf::PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
-                                                  const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
-                                                  void *csm_state_data) {
-    create_shader_module_api_state *csm_state = reinterpret_cast<create_shader_module_api_state *>(csm_state_data);
-    const bool pass = InstrumentShader(vvl::make_span(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)),
-                                       csm_state->instrumented_pgm, &csm_state->unique_shader_id);
-    if (pass) {
-        csm_state->instrumented_create_info.pCode = csm_state->instrumented_pgm.data();
-        csm_state->instrumented_create_info.codeSize = csm_state->instrumented_pgm.size() * sizeof(uint32_t);
-    }
+
+    // Every input of the instrumentation other than the shader id
+    std::vector<uint32_t> options = {static_cast<uint32_t>(container_type), desc_set_bind_index};
+    options.insert(options.end(), instrumentation_environment_key.begin(), instrumentation_environment_key.end());
+
+    const auto instrument = [&](uint32_t shader_id) {
+        // Load original shader SPIR-V
+        new_pgm.clear();
+        new_pgm.reserve(input.size());
+        new_pgm.insert(new_pgm.end(), &input.front(), &input.back() + 1);
+
+        Optimizer optimizer(target_env);
+        optimizer.SetMessageConsumer(debug_printf_console_message_consumer);
+        optimizer.RegisterPass(CreateInstDebugPrintfPass(desc_set_bind_index, shader_id));
+        const bool pass = optimizer.Run(new_pgm.data(), new_pgm.size(), &new_pgm, opt_options);
+        if (!pass) {
+            ReportSetupProblem(device, "Failure to instrument shader.  Proceeding with non-instrumented shader.");
+        }
+        return pass;
+    };
+    return InstrumentShaderCached(input, new_pgm, unique_shader_id, options, instrument);
 }
 
 vartype vartype_lookup(char intype) {
@@ -293,8 +306,10 @@ void snprintf_with_malloc(std::stringstream &shader_message, const DPFSubstring
     free(buffer);
 }
 
-void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, DPFBufferInfo &buffer_info,
-                                             uint32_t operation_index, uint32_t *const debug_output_buffer) {
+void DebugPrintf::AnalyzeAndGenerateMessages(const debug_printf_state::CommandBuffer &cb_node, VkQueue queue,
+                                             DPFBufferInfo &buffer_info, uint32_t operation_index,
+                                             uint32_t *const debug_output_buffer) {
+    const VkCommandBuffer command_buffer = cb_node.commandBuffer();
     // Word         Content
     //    0         Must be zero
     //    1         Size of output record, including this word
@@ -310,8 +325,25 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
     uint32_t expect = debug_output_buffer[1];
     if (!expect) return;
 
+    // A full buffer has no terminating zero, don't run into the output of the next command
+    const uint32_t buffer_words = output_buffer_size / sizeof(uint32_t);
     uint32_t index = spvtools::kDebugOutputDataOffset;
-    while (debug_output_buffer[index]) {
+    if (printf_log) {
+        // Leaves index on the terminating zero, the end of the buffer or a record that was cut short, so nothing is formatted below
+        index += printf_log->Write(printf_log_device_id, command_buffer, buffer_info.pipeline_bind_point, operation_index,
+                                   &debug_output_buffer[index], buffer_words - index,
+                                   [this, &cb_node](uint32_t shader_id, uint32_t string_id) {
+                                       GpuAssistedShaderTracker shader;
+                                       return cb_node.FindShader(shader_id, shader) ? FindFormatString(shader.pgm, string_id)
+                                                                                    : std::string();
+                                   });
+    }
+    while (index < buffer_words && debug_output_buffer[index]) {
+        // A record too small to hold a format string id, or running past the end of the buffer, was cut short
+        const uint32_t record_size = debug_output_buffer[index];
+        if (record_size < kDPFOutputRecordHeaderWords || record_size > buffer_words - index) {
+            break;
+        }
         std::stringstream shader_message;
         VkShaderModule shader_module_handle = VK_NULL_HANDLE;
         VkPipeline pipeline_handle = VK_NULL_HANDLE;
@@ -320,11 +352,11 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
         DPFOutputRecord *debug_record = reinterpret_cast<DPFOutputRecord *>(&debug_output_buffer[index]);
         // Lookup the VkShaderModule handle and SPIR-V code used to create the shader, using the unique shader ID value returned
         // by the instrumented shader.
-        auto it = shader_map.find(debug_record->shader_id);
-        if (it != shader_map.end()) {
-            shader_module_handle = it->second.shader_module;
-            pipeline_handle = it->second.pipeline;
-            pgm = it->second.pgm;
+        GpuAssistedShaderTracker shader;
+        if (cb_node.FindShader(debug_record->shader_id, shader)) {
+            shader_module_handle = shader.shader_module;
+            pipeline_handle = shader.pipeline;
+            pgm = shader.pgm;
         }
         assert(pgm.size() != 0);
         // Search through the shader source for the printf format string for this invocation
@@ -332,9 +364,14 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
         // Break the format string into strings with 1 or 0 value
         auto format_substrings = ParseFormatString(format_string);
         void *values = static_cast<void *>(&debug_record->values);
+        // The format string may need more values than the shader wrote if the record does not belong to it
+        uint32_t value_words = record_size - kDPFOutputRecordHeaderWords;
         const uint32_t static_size = 1024;
         // Sprintf each format substring into a temporary string then add that to the message
         for (auto &substring : format_substrings) {
+            if (substring.needs_value && value_words == 0) {
+                break;
+            }
             char temp_string[static_size];
             size_t needed = 0;
             std::vector<std::string> format_strings = {"%ul", "%lu", "%lx"};
@@ -348,6 +385,10 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
                 }
             }
             if (ul_pos != std::string::npos) {
+                if (value_words < 2) {
+                    break;
+                }
+                value_words -= 2;
                 // Unsigned 64 bit value
                 substring.longval = *static_cast<uint64_t *>(values);
                 values = static_cast<uint64_t *>(values) + 1;
@@ -373,6 +414,7 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
                             break;
                     }
                     values = static_cast<uint32_t *>(values) + 1;
+                    --value_words;
                 } else {
                     needed = snprintf(temp_string, static_size, substring.string.c_str());
                 }
@@ -410,16 +452,19 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
                 LogInfo(device, "UNASSIGNED-DEBUG-PRINTF", "%s", shader_message.str().c_str());
             }
         }
-        index += debug_record->size;
+        index += record_size;
     }
     if ((index - spvtools::kDebugOutputDataOffset) != expect) {
         LogWarning(device, "UNASSIGNED-DEBUG-PRINTF",
                    "WARNING - Debug Printf message was truncated, likely due to a buffer size that was too small for the message");
     }
-    memset(debug_output_buffer, 0, 4 * (debug_output_buffer[spvtools::kDebugOutputSizeOffset] + spvtools::kDebugOutputDataOffset));
+    // The shaders count every word they tried to write, which can be more than the buffer holds
+    const uint32_t words_to_clear =
+        std::min(expect, buffer_words - spvtools::kDebugOutputDataOffset) + spvtools::kDebugOutputDataOffset;
+    memset(debug_output_buffer, 0, sizeof(uint32_t) * words_to_clear);
 }
 
-// For the given command buffer, map its debug data buffers and read their contents for analysis.
+// For the given command buffer, read the contents of its debug data buffers for analysis.
 void debug_printf_state::CommandBuffer::Process(VkQueue queue) {
     auto *device_state = static_cast<DebugPrintf *>(dev_data);
     if (has_draw_cmd || has_trace_rays_cmd || has_dispatch_cmd) {
@@ -428,9 +473,8 @@ void debug_printf_state::CommandBuffer::Process(VkQueue queue) {
         uint32_t compute_index = 0;
         uint32_t ray_trace_index = 0;
 
+        bool printed = false;
         for (auto &buffer_info : gpu_buffer_list) {
-            char *data;
-
             uint32_t operation_index = 0;
             if (buffer_info.pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
                 operation_index = draw_index;
@@ -445,12 +489,34 @@ void debug_printf_state::CommandBuffer::Process(VkQueue queue) {
                 assert(false);
             }
 
-            VkResult result = vmaMapMemory(device_state->vmaAllocator, buffer_info.output_mem_block.allocation, (void **)&data);
-            if (result == VK_SUCCESS) {
-                device_state->AnalyzeAndGenerateMessages(commandBuffer(), queue, buffer_info, operation_index, (uint32_t *)data);
-                vmaUnmapMemory(device_state->vmaAllocator, buffer_info.output_mem_block.allocation);
+            // Most commands print nothing, only look at the records of those that did
+            auto *data = static_cast<uint32_t *>(buffer_info.output_mem_block.data);
+            if (data[spvtools::kDebugOutputSizeOffset] != 0) {
+                device_state->AnalyzeAndGenerateMessages(*this, queue, buffer_info, operation_index, data);
+                printed = true;
             }
         }
+        // Write out the log once per submitted command buffer, so that it is complete up to the last one processed even if
+        // the application never destroys the device
+        if (printed) {
+            device_state->FlushPrintfLog();
+        }
+    }
+}
+
+void debug_printf_state::CommandBuffer::GetOutputShaderIds(vvl::unordered_set<uint32_t> &shader_ids) const {
+    const uint32_t buffer_words = static_cast<const DebugPrintf *>(dev_data)->output_buffer_size / sizeof(uint32_t);
+    for (const auto &buffer_info : buffer_infos) {
+        const auto *data = static_cast<const uint32_t *>(buffer_info.output_mem_block.data);
+        if (data[spvtools::kDebugOutputSizeOffset] == 0) {
+            continue;
+        }
+        // Same walk as DebugPrintf::AnalyzeAndGenerateMessages, word 1 of each record is its shader id
+        uint32_t index = spvtools::kDebugOutputDataOffset;
+        while (index < buffer_words && data[index] >= kDPFOutputRecordHeaderWords && data[index] <= buffer_words - index) {
+            shader_ids.insert(data[index + 1]);
+            index += data[index];
+        }
     }
 }
 
@@ -667,12 +733,7 @@ void DebugPrintf::AllocateDebugPrintfResources(const VkCommandBuffer cmd_buffer,
 
     // Allocate memory for the output block that the gpu will use to return values for printf
     DPFDeviceMemoryBlock output_block = {};
-    VkBufferCreateInfo buffer_info = LvlInitStruct<VkBufferCreateInfo>();
-    buffer_info.size = output_buffer_size;
-    buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    VmaAllocationCreateInfo alloc_info = {};
-    alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    result = vmaCreateBuffer(vmaAllocator, &buffer_info, &alloc_info, &output_block.buffer, &output_block.allocation, nullptr);
+    result = cb_node->output_arena.Allocate(output_buffer_size, output_block);
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.");
         aborted = true;
@@ -680,19 +741,14 @@ void DebugPrintf::AllocateDebugPrintfResources(const VkCommandBuffer cmd_buffer,
     }
 
     // Clear the output block to zeros so that only printf values from the gpu will be present
-    uint32_t *data;
-    result = vmaMapMemory(vmaAllocator, output_block.allocation, reinterpret_cast<void **>(&data));
-    if (result == VK_SUCCESS) {
-        memset(data, 0, output_buffer_size);
-        vmaUnmapMemory(vmaAllocator, output_block.allocation);
-    }
+    memset(output_block.data, 0, output_buffer_size);
 
     auto desc_writes = LvlInitStruct<VkWriteDescriptorSet>();
     const uint32_t desc_count = 1;
 
     // Write the descriptor
     output_desc_buffer_info.buffer = output_block.buffer;
-    output_desc_buffer_info.offset = 0;
+    output_desc_buffer_info.offset = output_block.offset;
 
     desc_writes.descriptorCount = 1;
     desc_writes.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -726,16 +782,21 @@ std::shared_ptr<CMD_BUFFER_STATE> DebugPrintf::CreateCmdBufferState(VkCommandBuf
 
 debug_printf_state::CommandBuffer::CommandBuffer(DebugPrintf *dp, VkCommandBuffer cb,
                                                  const VkCommandBufferAllocateInfo *pCreateInfo, const COMMAND_POOL_STATE *pool)
-    : gpu_utils_state::CommandBuffer(dp, cb, pCreateInfo, pool) {}
+    : gpu_utils_state::CommandBuffer(dp, cb, pCreateInfo, pool),
+      output_arena(dp->vmaAllocator, VK_NULL_HANDLE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                   dp->phys_dev_props.limits.minStorageBufferOffsetAlignment, kOutputArenaBlockSize) {}
 
 debug_printf_state::CommandBuffer::~CommandBuffer() { Destroy(); }
 
 void debug_printf_state::CommandBuffer::Destroy() {
+    WaitForProcessing();
     ResetCBState();
+    output_arena.Destroy();
     CMD_BUFFER_STATE::Destroy();
 }
 
 void debug_printf_state::CommandBuffer::Reset() {
+    WaitForProcessing();
     CMD_BUFFER_STATE::Reset();
     ResetCBState();
 }
@@ -750,4 +811,5 @@ void debug_printf_state::CommandBuffer::ResetCBState() {
         debug_printf->DestroyBuffer(buffer_info);
     }
     buffer_infos.clear();
+    output_arena.Reset();
 }
@@ -17,13 +17,11 @@
 
 #pragma once
 
+#include "gpu_validation/debug_printf_log.h"
 #include "gpu_validation/gpu_utils.h"
 class DebugPrintf;
 
-struct DPFDeviceMemoryBlock {
-    VkBuffer buffer;
-    VmaAllocation allocation;
-};
+using DPFDeviceMemoryBlock = GpuAssistedBufferRange;
 
 struct DPFBufferInfo {
     DPFDeviceMemoryBlock output_mem_block;
@@ -54,11 +52,14 @@ struct DPFOutputRecord {
     uint32_t format_string_id;
     uint32_t values;
 };
+// Words of a record before its values
+static constexpr uint32_t kDPFOutputRecordHeaderWords = 8;
 
 namespace debug_printf_state {
 class CommandBuffer : public gpu_utils_state::CommandBuffer {
   public:
     std::vector<DPFBufferInfo> buffer_infos;
+    GpuAssistedBufferArena output_arena;
 
     CommandBuffer(DebugPrintf* dp, VkCommandBuffer cb, const VkCommandBufferAllocateInfo* create_info,
                   const COMMAND_POOL_STATE* pool);
@@ -66,6 +67,7 @@ class CommandBuffer : public gpu_utils_state::CommandBuffer {
 
     bool NeedsProcessing() const final { return !buffer_infos.empty(); }
     void Process(VkQueue queue) final;
+    void GetOutputShaderIds(vvl::unordered_set<uint32_t>& shader_ids) const final;
 
     void Destroy() final;
     void Reset() final;
@@ -87,15 +89,18 @@ class DebugPrintf : public GpuAssistedBase {
     }
 
     void CreateDevice(const VkDeviceCreateInfo* pCreateInfo) override;
+    void PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks* pAllocator) override;
     bool InstrumentShader(const vvl::span<const uint32_t>& input, std::vector<uint32_t>& new_pgm,
-                          uint32_t* unique_shader_id) override;
-    void PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
-                                         const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule,
-                                         void* csm_state_data) override;
+                          uint32_t unique_shader_id) override;
     std::vector<DPFSubstring> ParseFormatString(const std::string& format_string);
     std::string FindFormatString(vvl::span<const uint32_t> pgm, uint32_t string_id);
-    void AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, DPFBufferInfo& buffer_info,
+    void AnalyzeAndGenerateMessages(const debug_printf_state::CommandBuffer& cb_node, VkQueue queue, DPFBufferInfo& buffer_info,
                                     uint32_t operation_index, uint32_t* const debug_output_buffer);
+    void FlushPrintfLog() {
+        if (printf_log) {
+            printf_log->Flush();
+        }
+    }
     void PreCallRecordCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,
                               uint32_t firstInstance) override;
     void PreCallRecordCmdDrawMultiEXT(VkCommandBuffer commandBuffer, uint32_t drawCount, const VkMultiDrawInfoEXT* pVertexInfo,
@@ -174,4 +179,8 @@ class DebugPrintf : public GpuAssistedBase {
   private:
     bool verbose = false;
     bool use_stdout = false;
+    // When set, the records are logged as they are instead of being formatted into messages. Shared with the other devices
+    // logging to the same file.
+    std::shared_ptr<DebugPrintfLog> printf_log;
+    uint32_t printf_log_device_id = 0;
 };
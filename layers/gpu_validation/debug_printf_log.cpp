@@ -0,0 +1,137 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gpu_validation/debug_printf_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "utils/cast_utils.h"
+
+namespace {
+struct OpenLogs {
+    std::mutex lock;
+    vvl::unordered_map<std::string, std::weak_ptr<DebugPrintfLog>> logs;
+    // Paths opened earlier in the process are appended to, so a device created after the others were destroyed keeps their output
+    vvl::unordered_set<std::string> opened_paths;
+};
+
+OpenLogs &GetOpenLogs() {
+    static OpenLogs open_logs;
+    return open_logs;
+}
+
+std::atomic<uint32_t> next_device_id{1};
+}  // namespace
+
+std::shared_ptr<DebugPrintfLog> DebugPrintfLog::Open(const std::string &path) {
+    OpenLogs &open_logs = GetOpenLogs();
+    std::lock_guard<std::mutex> guard(open_logs.lock);
+    std::shared_ptr<DebugPrintfLog> log = open_logs.logs[path].lock();
+    if (!log) {
+        log.reset(new DebugPrintfLog(path, open_logs.opened_paths.count(path) != 0));
+        if (!log->file_) {
+            open_logs.logs.erase(path);
+            return nullptr;
+        }
+        open_logs.logs[path] = log;
+        open_logs.opened_paths.insert(path);
+    }
+    return log;
+}
+
+DebugPrintfLog::DebugPrintfLog(const std::string &path, bool append)
+    : file_(path, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc)) {
+    if (file_) {
+        words_.reserve(kFlushWords);
+        // The file may have been removed since the process last wrote it
+        file_.seekp(0, std::ios::end);
+        if (file_.tellp() == 0) {
+            words_.push_back(kFileMagic);
+            words_.push_back(kFileVersion);
+        }
+    }
+}
+
+uint32_t DebugPrintfLog::AddDevice() { return next_device_id++; }
+
+void DebugPrintfLog::RemoveDevice(uint32_t device_id) {
+    std::lock_guard<std::mutex> guard(lock_);
+    written_format_strings_.erase(device_id);
+}
+
+uint32_t DebugPrintfLog::Write(uint32_t device_id, VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point,
+                               uint32_t operation_index, const uint32_t *records, uint32_t max_words,
+                               const FindFormatString &find_format_string) {
+    // Each record starts with its size in words, and the last one is followed by a zero word unless the records fill the buffer.
+    // Records are at least 8 words long, a record that is shorter or runs past max_words was cut short and is not logged.
+    uint32_t logged_words = 0;
+    while (logged_words < max_words && records[logged_words] >= 8 && records[logged_words] <= max_words - logged_words) {
+        logged_words += records[logged_words];
+    }
+
+    std::lock_guard<std::mutex> guard(lock_);
+    if (!file_) {
+        return logged_words;
+    }
+    auto &written_format_strings = written_format_strings_[device_id];
+    // Word 1 of a record is the shader id, word 7 the format string id
+    for (uint32_t offset = 0; offset + 7 < logged_words; offset += records[offset]) {
+        const uint32_t shader_id = records[offset + 1];
+        const uint32_t string_id = records[offset + 7];
+        if (!written_format_strings.insert((static_cast<uint64_t>(shader_id) << 32) | string_id).second) {
+            continue;
+        }
+        const std::string format_string = find_format_string(shader_id, string_id);
+        words_.push_back(kFormatString);
+        words_.push_back(device_id);
+        words_.push_back(shader_id);
+        words_.push_back(string_id);
+        words_.push_back(static_cast<uint32_t>(format_string.size()));
+        const size_t string_offset = words_.size();
+        words_.resize(string_offset + (format_string.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0);
+        std::memcpy(&words_[string_offset], format_string.data(), format_string.size());
+    }
+
+    const uint64_t handle = CastToUint64(command_buffer);
+    words_.push_back(kCommand);
+    words_.push_back(device_id);
+    words_.push_back(static_cast<uint32_t>(handle));
+    words_.push_back(static_cast<uint32_t>(handle >> 32));
+    words_.push_back(bind_point);
+    words_.push_back(operation_index);
+    words_.push_back(logged_words);
+    words_.insert(words_.end(), records, records + logged_words);
+
+    if (words_.size() >= kFlushWords) {
+        FlushLocked();
+    }
+    return logged_words;
+}
+
+void DebugPrintfLog::Flush() {
+    std::lock_guard<std::mutex> guard(lock_);
+    FlushLocked();
+}
+
+void DebugPrintfLog::FlushLocked() {
+    if (file_ && !words_.empty()) {
+        file_.write(reinterpret_cast<const char *>(words_.data()), words_.size() * sizeof(uint32_t));
+        file_.flush();
+    }
+    words_.clear();
+}
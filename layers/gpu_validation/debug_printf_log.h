@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "vulkan/vulkan.h"
+#include "containers/custom_containers.h"
+
+// Binary log of Debug Printf output, written instead of formatting each message when khronos_validation.printf_log_file is set.
+// The records are copied as the shaders wrote them, and scripts/debug_printf_decode.py turns the file into text afterwards.
+//
+// Every device logging to the same path shares one file, which is truncated the first time the process opens it and appended to
+// afterwards. Shader ids are only unique within a device, so each device gets its own id for the life of the process.
+//
+// The file starts with kFileMagic and kFileVersion, followed by entries that each start with their EntryType and the device id:
+//   kFormatString  shader id, format string id, length in bytes, then the string padded to a whole word. Comes once per string,
+//                  before the first record that uses it.
+//   kCommand       command buffer handle (low word first), pipeline bind point, operation index, size in words of the records,
+//                  then the records of one draw, dispatch or trace rays command, as laid out in the Debug Printf output buffer.
+class DebugPrintfLog {
+  public:
+    enum EntryType : uint32_t {
+        kFormatString = 1,
+        kCommand = 2,
+    };
+    static constexpr uint32_t kFileMagic = 0x46505644;  // "DVPF"
+    static constexpr uint32_t kFileVersion = 2;
+
+    // Returns the format string with the given id in the shader with the given id
+    using FindFormatString = std::function<std::string(uint32_t shader_id, uint32_t string_id)>;
+
+    // Returns the log writing to path, or null if the file cannot be opened
+    static std::shared_ptr<DebugPrintfLog> Open(const std::string &path);
+    ~DebugPrintfLog() { Flush(); }
+
+    // Returns the id the device logs its records with, which RemoveDevice gives back when the device is destroyed
+    uint32_t AddDevice();
+    void RemoveDevice(uint32_t device_id);
+
+    // Logs the records at the start of records, up to the first zero word, or the first record that is cut short by max_words.
+    // Returns the number of words logged.
+    uint32_t Write(uint32_t device_id, VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, uint32_t operation_index,
+                   const uint32_t *records, uint32_t max_words, const FindFormatString &find_format_string);
+    void Flush();
+
+  private:
+    // Entries are gathered in memory and written out by Flush() after each command buffer is processed, or sooner once this
+    // many words are waiting
+    static constexpr size_t kFlushWords = 256 * 1024;
+
+    DebugPrintfLog(const std::string &path, bool append);
+    void FlushLocked();
+
+    std::mutex lock_;
+    std::ofstream file_;
+    std::vector<uint32_t> words_;
+    // By device id, shader id in the high word and format string id in the low word
+    vvl::unordered_map<uint32_t, vvl::unordered_set<uint64_t>> written_format_strings_;
+};
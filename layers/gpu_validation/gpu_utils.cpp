@@ -244,6 +244,64 @@ WriteLockGuard GpuAssistedBase::WriteLock() {
     }
 }
 
+VkResult GpuAssistedBufferArena::Allocate(VkDeviceSize size, GpuAssistedBufferRange &range) {
+    for (; current_block_ < blocks_.size(); ++current_block_, current_offset_ = 0) {
+        const Block &arena_block = blocks_[current_block_];
+        if (arena_block.size - current_offset_ >= size) {
+            break;
+        }
+    }
+    if (current_block_ == blocks_.size()) {
+        auto buffer_info = LvlInitStruct<VkBufferCreateInfo>();
+        buffer_info.size = std::max(size, block_size_);
+        buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        VmaAllocationCreateInfo alloc_info = {};
+        alloc_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        alloc_info.requiredFlags = required_flags_;
+        alloc_info.pool = pool_;
+        Block arena_block = {};
+        VmaAllocationInfo allocation_info = {};
+        VkResult result =
+            vmaCreateBuffer(allocator_, &buffer_info, &alloc_info, &arena_block.buffer, &arena_block.allocation, &allocation_info);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        arena_block.size = buffer_info.size;
+        arena_block.data = static_cast<uint8_t *>(allocation_info.pMappedData);
+        blocks_.emplace_back(arena_block);
+        current_offset_ = 0;
+    }
+
+    const Block &arena_block = blocks_[current_block_];
+    range.buffer = arena_block.buffer;
+    range.allocation = arena_block.allocation;
+    range.offset = current_offset_;
+    range.size = size;
+    range.data = arena_block.data + current_offset_;
+    // Keep the next range aligned for use as a storage buffer descriptor
+    const VkDeviceSize alignment = std::max(alignment_, VkDeviceSize(1));
+    current_offset_ = std::min(arena_block.size, ((current_offset_ + size + alignment - 1) / alignment) * alignment);
+    return VK_SUCCESS;
+}
+
+VkResult GpuAssistedBufferArena::Flush(const GpuAssistedBufferRange &range) const {
+    // vmaFlushAllocation does nothing for HOST_COHERENT memory, and takes care of nonCoherentAtomSize
+    return vmaFlushAllocation(allocator_, range.allocation, range.offset, range.size);
+}
+
+void GpuAssistedBufferArena::Reset() {
+    current_block_ = 0;
+    current_offset_ = 0;
+}
+
+void GpuAssistedBufferArena::Destroy() {
+    for (const auto &arena_block : blocks_) {
+        vmaDestroyBuffer(allocator_, arena_block.buffer, arena_block.allocation);
+    }
+    blocks_.clear();
+    Reset();
+}
+
 void GpuAssistedBase::PreCallRecordCreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
                                                 const VkAllocationCallbacks *pAllocator, VkDevice *pDevice, void *modified_ci) {
     ValidationStateTracker::PreCallRecordCreateDevice(gpu, pCreateInfo, pAllocator, pDevice, modified_ci);
@@ -293,6 +351,15 @@ void GpuAssistedBase::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
     assert(chain_info->u.pfnSetDeviceLoaderData);
     vkSetDeviceLoaderData = chain_info->u.pfnSetDeviceLoaderData;
 
+    if (GpuGetOption("khronos_validation.gpuav_shader_cache", false)) {
+        const char *cache_name =
+            (container_type == LayerObjectTypeDebugPrintf) ? "debug_printf_shader_cache" : "gpuav_instrumented_shader_cache";
+        instrumented_shader_cache = std::make_unique<InstrumentedShaderCache>(GetLayerCacheFilePath(cache_name));
+        instrumented_shader_cache->Load();
+    }
+    instrumentation_environment_key = MakeValidationEnvironmentKey(
+        PickSpirvEnv(api_version, IsExtEnabled(device_extensions.vk_khr_spirv_1_4)), device_extensions, enabled_features);
+
     // Some devices have extremely high limits here, so set a reasonable max because we have to pad
     // the pipeline layout with dummy descriptor set layouts.
     adjusted_max_desc_sets = phys_dev_props.limits.maxBoundDescriptorSets;
@@ -336,9 +403,24 @@ void GpuAssistedBase::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
         aborted = true;
         return;
     }
+
+    if (GpuGetOption("khronos_validation.gpuav_async_instrumentation", false)) {
+        instrumentation_pool = std::make_unique<ThreadPool>(std::max(1u, std::thread::hardware_concurrency() / 2));
+    }
+    if (GpuGetOption("khronos_validation.gpuav_async_processing", false)) {
+        processing_pool = std::make_unique<ThreadPool>(1);
+    }
 }
 
 void GpuAssistedBase::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    // Nothing will use the instrumentation of the modules that are still queued, so only the running ones are waited for. The
+    // queued processing still has messages to report, so it is let finish before the state it uses goes away.
+    if (instrumentation_pool) {
+        instrumentation_pool->DiscardQueued();
+        instrumentation_pool.reset();
+    }
+    processing_pool.reset();
+    async_instrumented_shaders.clear();
     if (debug_desc_layout) {
         DispatchDestroyDescriptorSetLayout(device, debug_desc_layout, NULL);
         debug_desc_layout = VK_NULL_HANDLE;
@@ -348,6 +430,10 @@ void GpuAssistedBase::PreCallRecordDestroyDevice(VkDevice device, const VkAlloca
         dummy_desc_layout = VK_NULL_HANDLE;
     }
     ValidationStateTracker::PreCallRecordDestroyDevice(device, pAllocator);
+    if (instrumented_shader_cache) {
+        instrumented_shader_cache->Save();
+        instrumented_shader_cache.reset();
+    }
     // State Tracker can end up making vma calls through callbacks - don't destroy allocator until ST is done
     if (output_buffer_pool) {
         vmaDestroyPool(vmaAllocator, output_buffer_pool);
@@ -358,6 +444,73 @@ void GpuAssistedBase::PreCallRecordDestroyDevice(VkDevice device, const VkAlloca
     desc_set_manager.reset();
 }
 
+bool GpuAssistedBase::InstrumentShaderCached(const vvl::span<const uint32_t> &input, std::vector<uint32_t> &new_pgm,
+                                             uint32_t shader_id, const std::vector<uint32_t> &options,
+                                             const std::function<bool(uint32_t)> &instrument) {
+    if (!instrumented_shader_cache || !InstrumentedShaderCache::CanCache(input)) {
+        return instrument(shader_id);
+    }
+    const auto key = InstrumentedShaderCache::MakeKey(input, options);
+    if (instrumented_shader_cache->Find(key, shader_id, new_pgm)) {
+        return true;
+    }
+    if (!instrument(InstrumentedShaderCache::kShaderIdPlaceholder)) {
+        return false;
+    }
+    if (instrumented_shader_cache->Add(key, new_pgm, shader_id)) {
+        return true;
+    }
+    // The shader id could not be told apart in the result, so it cannot be cached; instrument again with the real id
+    return instrument(shader_id);
+}
+
+// Create the instrumented shader data to provide to the driver.
+void GpuAssistedBase::PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
+                                                      const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
+                                                      void *csm_state_data) {
+    create_shader_module_api_state *csm_state = reinterpret_cast<create_shader_module_api_state *>(csm_state_data);
+    csm_state->unique_shader_id = unique_shader_module_id++;
+    // With async instrumentation, the driver gets the original code and the instrumentation starts once the module exists
+    if (!instrumentation_pool) {
+        const bool pass = InstrumentShader(vvl::make_span(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)),
+                                           csm_state->instrumented_pgm, csm_state->unique_shader_id);
+        if (pass) {
+            csm_state->instrumented_create_info.pCode = csm_state->instrumented_pgm.data();
+            csm_state->instrumented_create_info.codeSize = csm_state->instrumented_pgm.size() * sizeof(uint32_t);
+        }
+    }
+    ValidationStateTracker::PreCallRecordCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule, csm_state_data);
+}
+
+// Queue the instrumentation of the module, so that it overlaps with whatever the application does until it creates a pipeline
+// with the module. The instrumented code is only needed then, see UseAsyncInstrumentedShaders.
+void GpuAssistedBase::PostCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
+                                                       const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
+                                                       VkResult result, void *csm_state_data) {
+    ValidationStateTracker::PostCallRecordCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule, result,
+                                                             csm_state_data);
+    if (!instrumentation_pool || result != VK_SUCCESS || aborted) {
+        return;
+    }
+    auto module_state = Get<SHADER_MODULE_STATE>(*pShaderModule);
+    if (!module_state || !module_state->has_valid_spirv) {
+        return;
+    }
+    auto future = instrumentation_pool->Submit([this, module_state]() {
+        AsyncInstrumentedShader shader;
+        shader.pass = InstrumentShader(module_state->words_, shader.pgm, module_state->gpu_validation_shader_id);
+        return shader;
+    });
+    async_instrumented_shaders.insert_or_assign(*pShaderModule, future.share());
+}
+
+void GpuAssistedBase::PreCallRecordDestroyShaderModule(VkDevice device, VkShaderModule shaderModule,
+                                                       const VkAllocationCallbacks *pAllocator) {
+    // A pending instrumentation keeps its own reference to the module state, and its result is no longer needed
+    async_instrumented_shaders.erase(shaderModule);
+    ValidationStateTracker::PreCallRecordDestroyShaderModule(device, shaderModule, pAllocator);
+}
+
 gpu_utils_state::Queue::Queue(GpuAssistedBase &state, VkQueue q, uint32_t index, VkDeviceQueueCreateFlags flags,
                               const VkQueueFamilyProperties &queueFamilyProperties)
     : QUEUE_STATE(state, q, index, flags, queueFamilyProperties), state_(state) {}
@@ -439,20 +592,139 @@ bool GpuAssistedBase::CommandBufferNeedsProcessing(VkCommandBuffer command_buffe
     return false;
 }
 
+bool gpu_utils_state::CommandBuffer::FindShader(uint32_t shader_id, GpuAssistedShaderTracker &shader) const {
+    const auto snapshot = processing_shaders.find(shader_id);
+    if (snapshot != processing_shaders.end()) {
+        shader = snapshot->second;
+        return true;
+    }
+    const auto &shader_map = static_cast<const GpuAssistedBase *>(dev_data)->shader_map;
+    const auto it = shader_map.find(shader_id);
+    if (it == shader_map.end()) {
+        return false;
+    }
+    shader = it->second;
+    return true;
+}
+
+void gpu_utils_state::CommandBuffer::WaitForProcessing() {
+    if (pending_processing.valid()) {
+        pending_processing.wait();
+        pending_processing = {};
+    }
+    processing_shaders.clear();
+}
+
 void GpuAssistedBase::ProcessCommandBuffer(VkQueue queue, VkCommandBuffer command_buffer) {
     auto cb_node = GetWrite<gpu_utils_state::CommandBuffer>(command_buffer);
 
-    cb_node->Process(queue);
+    if (!processing_pool) {
+        cb_node->Process(queue);
+        for (auto *secondary_cmd_base : cb_node->linkedCommandBuffers) {
+            auto *secondary_cb_node = static_cast<gpu_utils_state::CommandBuffer *>(secondary_cmd_base);
+            auto guard = secondary_cb_node->WriteLock();
+            secondary_cb_node->Process(queue);
+        }
+        return;
+    }
+
+    // The worker reads the command buffers without locking them. Nothing modifies them until it is done, because they are only
+    // reset, destroyed or submitted again after WaitForProcessing(). The secondary command buffers are gathered here, as
+    // linkedCommandBuffers changes when one of them is destroyed.
+    std::vector<std::shared_ptr<gpu_utils_state::CommandBuffer>> cb_nodes;
+    cb_nodes.emplace_back(cb_node);
+    for (auto *secondary_cmd_base : cb_node->linkedCommandBuffers) {
+        cb_nodes.emplace_back(std::static_pointer_cast<gpu_utils_state::CommandBuffer>(secondary_cmd_base->shared_from_this()));
+    }
+    const auto take_shader_snapshot = [this](gpu_utils_state::CommandBuffer &node) {
+        vvl::unordered_set<uint32_t> shader_ids;
+        node.GetOutputShaderIds(shader_ids);
+        node.processing_shaders.clear();
+        for (const uint32_t shader_id : shader_ids) {
+            auto it = shader_map.find(shader_id);
+            if (it != shader_map.end()) {
+                node.processing_shaders.emplace(shader_id, std::move(it->second));
+            }
+        }
+    };
+    take_shader_snapshot(*cb_node);
+    for (size_t i = 1; i < cb_nodes.size(); ++i) {
+        auto guard = cb_nodes[i]->WriteLock();
+        take_shader_snapshot(*cb_nodes[i]);
+    }
+
+    auto future = processing_pool
+                      ->Submit([queue, cb_nodes]() {
+                          for (const auto &node : cb_nodes) {
+                              node->Process(queue);
+                          }
+                      })
+                      .share();
+    cb_node->pending_processing = future;
+    for (size_t i = 1; i < cb_nodes.size(); ++i) {
+        auto guard = cb_nodes[i]->WriteLock();
+        cb_nodes[i]->pending_processing = future;
+    }
+}
+
+void GpuAssistedBase::WaitForCommandBufferProcessing(VkCommandBuffer command_buffer) {
+    if (!processing_pool) {
+        return;
+    }
+    auto cb_node = GetWrite<gpu_utils_state::CommandBuffer>(command_buffer);
+    cb_node->WaitForProcessing();
     for (auto *secondary_cmd_base : cb_node->linkedCommandBuffers) {
         auto *secondary_cb_node = static_cast<gpu_utils_state::CommandBuffer *>(secondary_cmd_base);
         auto guard = secondary_cb_node->WriteLock();
-        secondary_cb_node->Process(queue);
+        secondary_cb_node->WaitForProcessing();
+    }
+}
+
+void GpuAssistedBase::WaitForAllProcessing() {
+    if (processing_pool) {
+        // The pool has a single worker, so this task only runs once everything queued before it is done
+        processing_pool->Submit([]() {}).wait();
+    }
+}
+
+// The device overwrites the output of a command buffer when it runs it again, so the output of its last submission must have been
+// read first
+void GpuAssistedBase::PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits,
+                                               VkFence fence) {
+    ValidationStateTracker::PreCallRecordQueueSubmit(queue, submitCount, pSubmits, fence);
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        const VkSubmitInfo *submit = &pSubmits[submit_idx];
+        for (uint32_t i = 0; i < submit->commandBufferCount; i++) {
+            WaitForCommandBufferProcessing(submit->pCommandBuffers[i]);
+        }
+    }
+}
+
+void GpuAssistedBase::PreCallRecordQueueSubmit2KHR(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2KHR *pSubmits,
+                                                   VkFence fence) {
+    ValidationStateTracker::PreCallRecordQueueSubmit2KHR(queue, submitCount, pSubmits, fence);
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        const VkSubmitInfo2KHR *submit = &pSubmits[submit_idx];
+        for (uint32_t i = 0; i < submit->commandBufferInfoCount; i++) {
+            WaitForCommandBufferProcessing(submit->pCommandBufferInfos[i].commandBuffer);
+        }
+    }
+}
+
+void GpuAssistedBase::PreCallRecordQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2 *pSubmits,
+                                                VkFence fence) {
+    ValidationStateTracker::PreCallRecordQueueSubmit2(queue, submitCount, pSubmits, fence);
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        const VkSubmitInfo2 *submit = &pSubmits[submit_idx];
+        for (uint32_t i = 0; i < submit->commandBufferInfoCount; i++) {
+            WaitForCommandBufferProcessing(submit->pCommandBufferInfos[i].commandBuffer);
+        }
     }
 }
 
 // Issue a memory barrier to make GPU-written data available to host.
 // Wait for the queue to complete execution.
-// Check the debug buffers for all the command buffers that were submitted.
+// Check the debug buffers for all the command buffers that were submitted, or hand them to processing_pool.
 void GpuAssistedBase::PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence,
                                                 VkResult result) {
     ValidationStateTracker::PostCallRecordQueueSubmit(queue, submitCount, pSubmits, fence, result);
@@ -517,6 +789,47 @@ void GpuAssistedBase::PostCallRecordQueueSubmit2(VkQueue queue, uint32_t submitC
     RecordQueueSubmit2(queue, submitCount, pSubmits, fence, result);
 }
 
+// Once the application has waited for its work, it expects the messages about that work to have been reported
+void GpuAssistedBase::PostCallRecordQueueWaitIdle(VkQueue queue, VkResult result) {
+    ValidationStateTracker::PostCallRecordQueueWaitIdle(queue, result);
+    WaitForAllProcessing();
+}
+
+void GpuAssistedBase::PostCallRecordDeviceWaitIdle(VkDevice device, VkResult result) {
+    ValidationStateTracker::PostCallRecordDeviceWaitIdle(device, result);
+    WaitForAllProcessing();
+}
+
+void GpuAssistedBase::PostCallRecordWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences, VkBool32 waitAll,
+                                                  uint64_t timeout, VkResult result) {
+    ValidationStateTracker::PostCallRecordWaitForFences(device, fenceCount, pFences, waitAll, timeout, result);
+    WaitForAllProcessing();
+}
+
+// Only a signaled fence or semaphore tells the application that its work is done, polling one that is not must not block
+void GpuAssistedBase::PostCallRecordGetFenceStatus(VkDevice device, VkFence fence, VkResult result) {
+    ValidationStateTracker::PostCallRecordGetFenceStatus(device, fence, result);
+    if (result == VK_SUCCESS) {
+        WaitForAllProcessing();
+    }
+}
+
+void GpuAssistedBase::PostCallRecordWaitSemaphores(VkDevice device, const VkSemaphoreWaitInfo *pWaitInfo, uint64_t timeout,
+                                                   VkResult result) {
+    ValidationStateTracker::PostCallRecordWaitSemaphores(device, pWaitInfo, timeout, result);
+    if (result == VK_SUCCESS) {
+        WaitForAllProcessing();
+    }
+}
+
+void GpuAssistedBase::PostCallRecordWaitSemaphoresKHR(VkDevice device, const VkSemaphoreWaitInfo *pWaitInfo, uint64_t timeout,
+                                                      VkResult result) {
+    ValidationStateTracker::PostCallRecordWaitSemaphoresKHR(device, pWaitInfo, timeout, result);
+    if (result == VK_SUCCESS) {
+        WaitForAllProcessing();
+    }
+}
+
 // Just gives a warning about a possible deadlock.
 bool GpuAssistedBase::ValidateCmdWaitEvents(VkCommandBuffer command_buffer, VkPipelineStageFlags2 src_stage_mask,
                                             CMD_TYPE cmd_type) const {
@@ -740,21 +1053,6 @@ void GpuAssistedBase::PreCallRecordDestroyPipeline(VkDevice device, VkPipeline p
     ValidationStateTracker::PreCallRecordDestroyPipeline(device, pipeline, pAllocator);
 }
 
-template <typename CreateInfo>
-VkShaderModule GetShaderModule(const CreateInfo &createInfo, VkShaderStageFlagBits stage) {
-    for (uint32_t i = 0; i < createInfo.stageCount; ++i) {
-        if (createInfo.pStages[i].stage == stage) {
-            return createInfo.pStages[i].module;
-        }
-    }
-    return {};
-}
-
-template <>
-VkShaderModule GetShaderModule(const VkComputePipelineCreateInfo &createInfo, VkShaderStageFlagBits) {
-    return createInfo.stage.module;
-}
-
 template <typename SafeType>
 void SetShaderModule(SafeType &createInfo, const safe_VkPipelineShaderStageCreateInfo &stage_info, VkShaderModule shader_module,
                      uint32_t stage_ci_index) {
@@ -786,6 +1084,56 @@ safe_VkPipelineShaderStageCreateInfo &GetShaderStageCI(safe_VkComputePipelineCre
     return ci.stage;
 }
 
+// Access to the shader stages of a create info by their index in it
+template <typename CreateInfo>
+uint32_t GetShaderStageCount(const CreateInfo &ci) {
+    return ci.stageCount;
+}
+
+static uint32_t GetShaderStageCount(const VkComputePipelineCreateInfo &) { return 1; }
+static uint32_t GetShaderStageCount(const safe_VkComputePipelineCreateInfo &) { return 1; }
+
+template <typename CreateInfo>
+auto &GetShaderStageCIAt(CreateInfo &ci, uint32_t index) {
+    return ci.pStages[index];
+}
+
+static const VkPipelineShaderStageCreateInfo &GetShaderStageCIAt(const VkComputePipelineCreateInfo &ci, uint32_t) {
+    return ci.stage;
+}
+static safe_VkPipelineShaderStageCreateInfo &GetShaderStageCIAt(safe_VkComputePipelineCreateInfo &ci, uint32_t) {
+    return ci.stage;
+}
+
+template <typename SafeCreateInfo>
+void GpuAssistedBase::UseAsyncInstrumentedShaders(SafeCreateInfo &create_info, const VkAllocationCallbacks *pAllocator) {
+    for (uint32_t i = 0; i < GetShaderStageCount(create_info); ++i) {
+        auto &stage_ci = GetShaderStageCIAt(create_info, i);
+        if (stage_ci.module == VK_NULL_HANDLE) {
+            continue;
+        }
+        const auto instrumented = async_instrumented_shaders.find(stage_ci.module);
+        if (!instrumented->first) {
+            continue;
+        }
+        // Only blocks if the instrumentation of this module is still queued or running
+        const AsyncInstrumentedShader &shader = instrumented->second.get();
+        if (!shader.pass) {
+            continue;
+        }
+        VkShaderModule shader_module;
+        auto create_info_sm = LvlInitStruct<VkShaderModuleCreateInfo>();
+        create_info_sm.pCode = shader.pgm.data();
+        create_info_sm.codeSize = shader.pgm.size() * sizeof(uint32_t);
+        VkResult result = DispatchCreateShaderModule(device, &create_info_sm, pAllocator, &shader_module);
+        if (result == VK_SUCCESS) {
+            stage_ci.module = shader_module;
+        } else {
+            ReportSetupProblem(device, "Unable to create instrumented shader module.  Proceeding with non-instrumented shader.");
+        }
+    }
+}
+
 // Examine the pipelines to see if they use the debug descriptor set binding index.
 // If any do, create new non-instrumented shader modules and use them to replace the instrumented
 // shaders in the pipeline.  Return the (possibly) modified create infos to the caller.
@@ -822,6 +1170,11 @@ void GpuAssistedBase::PreCallRecordPipelineCreations(uint32_t count, const Creat
             for (uint32_t i = 0; i < static_cast<uint32_t>(pipe->stage_states.size()); ++i) {
                 const auto &stage = pipe->stage_states[i];
                 const auto &module_state = stage.module_state;
+                // Modules instrumented in the background were given to the driver with their original code
+                const auto app_module = module_state->Handle().Cast<VkShaderModule>();
+                if (app_module != VK_NULL_HANDLE && async_instrumented_shaders.find(app_module)->first) {
+                    continue;
+                }
 
                 VkShaderModule shader_module;
                 auto create_info = LvlInitStruct<VkShaderModuleCreateInfo>();
@@ -837,6 +1190,9 @@ void GpuAssistedBase::PreCallRecordPipelineCreations(uint32_t count, const Creat
                 }
             }
         } else {
+            if (instrumentation_pool) {
+                UseAsyncInstrumentedShaders(new_pipeline_ci, pAllocator);
+            }
             // !replace_shaders implies that the instrumented shaders should be used. However, if this is a non-executable pipeline
             // library created with pre-raster or fragment shader state, it contains shaders that have not yet been instrumented
             if (!pipe->HasFullState() && (pipe->pre_raster_state || pipe->fragment_shader_state)) {
@@ -850,8 +1206,9 @@ void GpuAssistedBase::PreCallRecordPipelineCreations(uint32_t count, const Creat
                         }
                         const VkShaderStageFlagBits stage = stage_state.create_info->stage;
                         auto &csm_state = cgpl_state.shader_states[pipeline][stage];
+                        csm_state.unique_shader_id = unique_shader_module_id++;
                         const auto pass =
-                            InstrumentShader(module_state->words_, csm_state.instrumented_pgm, &csm_state.unique_shader_id);
+                            InstrumentShader(module_state->words_, csm_state.instrumented_pgm, csm_state.unique_shader_id);
                         if (pass) {
                             module_state->gpu_validation_shader_id = csm_state.unique_shader_id;
 
@@ -875,9 +1232,10 @@ void GpuAssistedBase::PreCallRecordPipelineCreations(uint32_t count, const Creat
     }
 }
 // For every pipeline:
+// - For every shader module that had to be replaced in PreCallRecord (because the pipeline is using the debug desc set index, or
+//   by its instrumented copy):
+//   - Destroy it since it has been bound into the pipeline by now.  This is our only chance to delete it.
 // - For every shader in a pipeline:
-//   - If the shader had to be replaced in PreCallRecord (because the pipeline is using the debug desc set index):
-//     - Destroy it since it has been bound into the pipeline by now.  This is our only chance to delete it.
 //   - Track the shader in the shader_map
 //   - Save the shader binary if it contains debug code
 template <typename CreateInfo, typename SafeCreateInfo>
@@ -890,23 +1248,22 @@ void GpuAssistedBase::PostCallRecordPipelineCreations(const uint32_t count, cons
         return;
     }
     for (uint32_t pipeline = 0; pipeline < count; ++pipeline) {
+        const auto *modified_ci = reinterpret_cast<const CreateInfo *>(modified_create_infos[pipeline].ptr());
+        for (uint32_t i = 0; i < GetShaderStageCount(*modified_ci); ++i) {
+            const VkShaderModule replaced_module = GetShaderStageCIAt(*modified_ci, i).module;
+            if (replaced_module != GetShaderStageCIAt(pCreateInfos[pipeline], i).module) {
+                DispatchDestroyShaderModule(device, replaced_module, pAllocator);
+            }
+        }
+
         auto pipeline_state = Get<PIPELINE_STATE>(pPipelines[pipeline]);
         if (!pipeline_state) continue;
 
         if (!pipeline_state->stage_states.empty() && !(pipeline_state->create_flags & VK_PIPELINE_CREATE_LIBRARY_BIT_KHR)) {
-            const auto pipeline_layout = pipeline_state->PipelineLayoutState();
             for (auto &stage_state : pipeline_state->stage_states) {
                 auto &module_state = stage_state.module_state;
                 const auto shader_module = module_state->Handle();
 
-                if (pipeline_state->active_slots.find(desc_set_bind_index) != pipeline_state->active_slots.end() ||
-                    (pipeline_layout->set_layouts.size() >= adjusted_max_desc_sets)) {
-                    auto *modified_ci = reinterpret_cast<const CreateInfo *>(modified_create_infos[pipeline].ptr());
-                    auto uninstrumented_module = GetShaderModule(*modified_ci, stage_state.create_info->stage);
-                    assert(uninstrumented_module != shader_module.Cast<VkShaderModule>());
-                    DispatchDestroyShaderModule(device, uninstrumented_module, pAllocator);
-                }
-
                 std::vector<unsigned int> code;
                 // Save the shader binary
                 // The core_validation ShaderModule tracker saves the binary too, but discards it when the ShaderModule
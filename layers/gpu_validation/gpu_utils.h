@@ -17,10 +17,12 @@
 #pragma once
 #include "generated/chassis.h"
 #include "core_checks/cc_shader.h"
+#include "gpu_validation/instrumented_shader_cache.h"
 #include "state_tracker/cmd_buffer_state.h"
 #include "state_tracker/state_tracker.h"
 #include "vma/vma.h"
 #include "state_tracker/queue_state.h"
+#include "utils/thread_pool.h"
 
 class GpuAssistedBase;
 
@@ -52,6 +54,59 @@ class UtilDescriptorSetManager {
     mutable std::mutex lock_;
 };
 
+// Size of the buffers of the arenas holding the output blocks, which are small. Larger blocks get a VMA buffer of their own.
+static const VkDeviceSize kOutputArenaBlockSize = 64 * 1024;
+
+// A range of one of the persistently mapped buffers of a GpuAssistedBufferArena
+struct GpuAssistedBufferRange {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void *data = nullptr;
+};
+
+// Hands out the buffers GPU-AV and Debug Printf record for each draw, dispatch and trace rays command of a command buffer. They are
+// carved out of a few large, persistently mapped VMA buffers instead of being buffers of their own, and are all released at once by
+// Reset(), when the command buffer is reset (so has completed). The VMA buffers are kept for the next recording.
+class GpuAssistedBufferArena {
+  public:
+    GpuAssistedBufferArena(VmaAllocator allocator, VmaPool pool, VkMemoryPropertyFlags required_flags, VkDeviceSize alignment,
+                           VkDeviceSize block_size)
+        : allocator_(allocator), pool_(pool), required_flags_(required_flags), alignment_(alignment), block_size_(block_size) {}
+    ~GpuAssistedBufferArena() { Destroy(); }
+
+    VkResult Allocate(VkDeviceSize size, GpuAssistedBufferRange &range);
+    // Makes host writes to range visible to the device, if the memory is not HOST_COHERENT
+    VkResult Flush(const GpuAssistedBufferRange &range) const;
+    void Reset();
+    void Destroy();
+
+  private:
+    struct Block {
+        VkBuffer buffer;
+        VmaAllocation allocation;
+        VkDeviceSize size;
+        uint8_t *data;
+    };
+
+    const VmaAllocator allocator_;
+    const VmaPool pool_;
+    const VkMemoryPropertyFlags required_flags_;
+    const VkDeviceSize alignment_;
+    const VkDeviceSize block_size_;
+
+    std::vector<Block> blocks_;
+    size_t current_block_ = 0;
+    VkDeviceSize current_offset_ = 0;
+};
+
+struct GpuAssistedShaderTracker {
+    VkPipeline pipeline;
+    VkShaderModule shader_module;
+    std::vector<uint32_t> pgm;
+};
+
 namespace gpu_utils_state {
 class Queue : public QUEUE_STATE {
   public:
@@ -73,6 +128,19 @@ class CommandBuffer : public CMD_BUFFER_STATE {
 
     virtual bool NeedsProcessing() const = 0;
     virtual void Process(VkQueue queue) = 0;
+    // Adds the ids of the shaders that wrote to the output of the last submission to shader_ids
+    virtual void GetOutputShaderIds(vvl::unordered_set<uint32_t> &shader_ids) const = 0;
+
+    // Returns the shader_map entry of shader_id, as it was when the command buffer was handed to the processing pool if it was
+    bool FindShader(uint32_t shader_id, GpuAssistedShaderTracker &shader) const;
+
+    // Waits until the results of the last submission are no longer being read on the processing pool. Must be called before the
+    // command buffer (and so its output blocks) is reset, destroyed or submitted again.
+    void WaitForProcessing();
+    std::shared_future<void> pending_processing;
+    // The shader_map entries of the shaders in the output being processed. They are copied when the command buffer is handed to
+    // the processing pool, as the application may destroy the pipelines before the worker gets to the output.
+    vvl::unordered_map<uint32_t, GpuAssistedShaderTracker> processing_shaders;
 };
 }  // namespace gpu_utils_state
 VALSTATETRACK_DERIVED_STATE_OBJECT(VkQueue, gpu_utils_state::Queue, QUEUE_STATE)
@@ -88,12 +156,6 @@ void UtilGenerateCommonMessage(const debug_report_data *report_data, const VkCom
 void UtilGenerateSourceMessages(vvl::span<const uint32_t> pgm, const uint32_t *debug_record, bool from_printf,
                                 std::string &filename_msg, std::string &source_msg);
 
-struct GpuAssistedShaderTracker {
-    VkPipeline pipeline;
-    VkShaderModule shader_module;
-    std::vector<uint32_t> pgm;
-};
-
 class GpuAssistedBase : public ValidationStateTracker {
   public:
     ReadLockGuard ReadLock() const override;
@@ -103,6 +165,10 @@ class GpuAssistedBase : public ValidationStateTracker {
     void CreateDevice(const VkDeviceCreateInfo *pCreateInfo) override;
     void PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) override;
 
+    void PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence) override;
+    void PreCallRecordQueueSubmit2KHR(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2KHR *pSubmits,
+                                      VkFence fence) override;
+    void PreCallRecordQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2 *pSubmits, VkFence fence) override;
     void PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence,
                                    VkResult result) override;
     void RecordQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2KHR *pSubmits, VkFence fence, VkResult result);
@@ -110,6 +176,15 @@ class GpuAssistedBase : public ValidationStateTracker {
                                        VkResult result) override;
     void PostCallRecordQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2 *pSubmits, VkFence fence,
                                     VkResult result) override;
+    void PostCallRecordQueueWaitIdle(VkQueue queue, VkResult result) override;
+    void PostCallRecordDeviceWaitIdle(VkDevice device, VkResult result) override;
+    void PostCallRecordWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences, VkBool32 waitAll,
+                                     uint64_t timeout, VkResult result) override;
+    void PostCallRecordGetFenceStatus(VkDevice device, VkFence fence, VkResult result) override;
+    void PostCallRecordWaitSemaphores(VkDevice device, const VkSemaphoreWaitInfo *pWaitInfo, uint64_t timeout,
+                                      VkResult result) override;
+    void PostCallRecordWaitSemaphoresKHR(VkDevice device, const VkSemaphoreWaitInfo *pWaitInfo, uint64_t timeout,
+                                         VkResult result) override;
     bool ValidateCmdWaitEvents(VkCommandBuffer command_buffer, VkPipelineStageFlags2 src_stage_mask, CMD_TYPE cmd_type) const;
     bool PreCallValidateCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEvent *pEvents,
                                       VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
@@ -163,6 +238,14 @@ class GpuAssistedBase : public ValidationStateTracker {
                                                     const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                                     VkResult result, void *crtpl_state_data) override;
     void PreCallRecordDestroyPipeline(VkDevice device, VkPipeline pipeline, const VkAllocationCallbacks *pAllocator) override;
+    void PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
+                                         const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
+                                         void *csm_state_data) override;
+    void PostCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
+                                          const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule, VkResult result,
+                                          void *csm_state_data) override;
+    void PreCallRecordDestroyShaderModule(VkDevice device, VkShaderModule shaderModule,
+                                          const VkAllocationCallbacks *pAllocator) override;
 
     template <typename T>
     void ReportSetupProblem(T object, const char *const specific_message, bool vma_fail = false) const {
@@ -177,7 +260,7 @@ class GpuAssistedBase : public ValidationStateTracker {
         LogError(object, setup_vuid, "Setup Error. Detail: (%s)", logit.c_str());
     }
     bool GpuGetOption(const char *option, bool default_value) {
-        std::string option_string = getLayerOption(option);
+        std::string option_string = GetLayerOptionOrEnvVar(option);
         transform(option_string.begin(), option_string.end(), option_string.begin(), ::tolower);
         return !option_string.empty() ? !option_string.compare("true") : default_value;
     }
@@ -185,6 +268,9 @@ class GpuAssistedBase : public ValidationStateTracker {
   protected:
     bool CommandBufferNeedsProcessing(VkCommandBuffer command_buffer) const;
     void ProcessCommandBuffer(VkQueue queue, VkCommandBuffer command_buffer);
+    void WaitForCommandBufferProcessing(VkCommandBuffer command_buffer);
+    // Waits until the results of every submission made so far have been reported
+    void WaitForAllProcessing();
 
     void SubmitBarrier(VkQueue queue) {
         auto queue_state = Get<gpu_utils_state::Queue>(queue);
@@ -209,17 +295,33 @@ class GpuAssistedBase : public ValidationStateTracker {
                                          const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
                                          const VkPipelineBindPoint bind_point, const SafeCreateInfo &modified_create_infos);
 
+    // Must be safe to call from instrumentation_pool while the application keeps using the device
     virtual bool InstrumentShader(const vvl::span<const uint32_t> &input, std::vector<uint32_t> &new_pgm,
-                                  uint32_t *unique_shader_id) = 0;
+                                  uint32_t unique_shader_id) = 0;
+    // Calls instrument(shader id) to instrument input into new_pgm, unless instrumented_shader_cache already has the result for
+    // input and options (every input of the instrumentation other than the shader id)
+    bool InstrumentShaderCached(const vvl::span<const uint32_t> &input, std::vector<uint32_t> &new_pgm, uint32_t shader_id,
+                                const std::vector<uint32_t> &options, const std::function<bool(uint32_t)> &instrument);
+
+    // Result of instrumenting a shader module on instrumentation_pool
+    struct AsyncInstrumentedShader {
+        bool pass = false;
+        std::vector<uint32_t> pgm;
+    };
+    // Waits for the instrumentation of the stage modules of create_info, and points the stages at temporary instrumented copies
+    // of their modules, which PostCallRecordPipelineCreations destroys
+    template <typename SafeCreateInfo>
+    void UseAsyncInstrumentedShaders(SafeCreateInfo &create_info, const VkAllocationCallbacks *pAllocator);
 
   public:
-    bool aborted = false;
+    // Read by the instrumentation and processing workers
+    std::atomic<bool> aborted{false};
     PFN_vkSetDeviceLoaderData vkSetDeviceLoaderData;
     const char *setup_vuid;
     VkPhysicalDeviceFeatures supported_features{};
     VkPhysicalDeviceFeatures desired_features{};
     uint32_t adjusted_max_desc_sets = 0;
-    uint32_t unique_shader_module_id = 0;
+    std::atomic<uint32_t> unique_shader_module_id{0};
     uint32_t output_buffer_size = 0;
     VkDescriptorSetLayout debug_desc_layout = VK_NULL_HANDLE;
     VkDescriptorSetLayout dummy_desc_layout = VK_NULL_HANDLE;
@@ -227,6 +329,17 @@ class GpuAssistedBase : public ValidationStateTracker {
     VmaAllocator vmaAllocator = {};
     VmaPool output_buffer_pool = VK_NULL_HANDLE;
     std::unique_ptr<UtilDescriptorSetManager> desc_set_manager;
+    std::unique_ptr<InstrumentedShaderCache> instrumented_shader_cache;
+    // Target environment, extensions and features of the device, the part of the instrumentation options that is fixed at
+    // device creation
+    ValidationCache::Key instrumentation_environment_key{};
+    // When set, modules are created with their original code and instrumented in the background, see
+    // PostCallRecordCreateShaderModule
+    std::unique_ptr<ThreadPool> instrumentation_pool;
+    vl_concurrent_unordered_map<VkShaderModule, std::shared_future<AsyncInstrumentedShader>> async_instrumented_shaders;
+    // When set, the output of submitted command buffers is read and turned into messages on this single worker, in submission
+    // order, instead of within vkQueueSubmit. See ProcessCommandBuffer.
+    std::unique_ptr<ThreadPool> processing_pool;
     vl_concurrent_unordered_map<uint32_t, GpuAssistedShaderTracker> shader_map;
     std::vector<VkDescriptorSetLayoutBinding> bindings_;
 };
@@ -209,6 +209,7 @@ void GpuAssistedPreDispatchValidationState::Destroy(VkDevice device) {
 
 // Clean up device-related resources
 void GpuAssisted::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    buffer_address_table.reset();
     acceleration_structure_validation_state.Destroy(device, vmaAllocator);
     pre_draw_validation_state.Destroy(device);
     pre_dispatch_validation_state.Destroy(device);
@@ -834,12 +835,9 @@ void GpuAssisted::PostCallRecordBindAccelerationStructureMemoryNV(VkDevice devic
     }
 }
 
-// Free the device memory and descriptor set(s) associated with a command buffer.
+// Free the descriptor set(s) associated with a command buffer.
 void GpuAssisted::DestroyBuffer(GpuAssistedBufferInfo &buffer_info) {
-    vmaDestroyBuffer(vmaAllocator, buffer_info.output_mem_block.buffer, buffer_info.output_mem_block.allocation);
-    if (buffer_info.bda_input_mem_block.buffer) {
-        vmaDestroyBuffer(vmaAllocator, buffer_info.bda_input_mem_block.buffer, buffer_info.bda_input_mem_block.allocation);
-    }
+    // The output and input blocks are released with the arenas of the command buffer, see GpuAssistedBufferArena
     if (buffer_info.desc_set != VK_NULL_HANDLE) {
         desc_set_manager->PutBackDescriptorSet(buffer_info.desc_pool, buffer_info.desc_set);
     }
@@ -914,7 +912,7 @@ bool GpuValidateShader(const vvl::span<const uint32_t> &input, bool SetRelaxBloc
 
 // Call the SPIR-V Optimizer to run the instrumentation pass on the shader.
 bool GpuAssisted::InstrumentShader(const vvl::span<const uint32_t> &input, std::vector<uint32_t> &new_pgm,
-                                   uint32_t *unique_shader_id) {
+                                   uint32_t unique_shader_id) {
     if (aborted) return false;
     if (input[0] != spv::MagicNumber) return false;
 
@@ -932,11 +930,6 @@ bool GpuAssisted::InstrumentShader(const vvl::span<const uint32_t> &input, std::
         }
     };
 
-    // Load original shader SPIR-V
-    new_pgm.clear();
-    new_pgm.reserve(input.size());
-    new_pgm.insert(new_pgm.end(), &input.front(), &input.back() + 1);
-
     // Call the optimizer to instrument the shader.
     // Use the unique_shader_module_id as a shader ID so we can look up its handle later in the shader_map.
     // If descriptor indexing is enabled, enable length checks and updated descriptor checks
@@ -947,44 +940,47 @@ bool GpuAssisted::InstrumentShader(const vvl::span<const uint32_t> &input, std::
     spvtools::OptimizerOptions opt_options;
     opt_options.set_run_validator(true);
     opt_options.set_validator_options(val_options);
-    Optimizer optimizer(target_env);
-    optimizer.SetMessageConsumer(gpu_console_message_consumer);
-    optimizer.RegisterPass(CreateInstBindlessCheckPass(desc_set_bind_index, unique_shader_module_id, descriptor_indexing,
-                                                       descriptor_indexing, buffer_oob_enabled, buffer_oob_enabled));
-    // Call CreateAggressiveDCEPass with preserve_interface == true
-    optimizer.RegisterPass(CreateAggressiveDCEPass(true));
-    if ((IsExtEnabled(device_extensions.vk_ext_buffer_device_address) ||
-         IsExtEnabled(device_extensions.vk_khr_buffer_device_address)) &&
-        shaderInt64 && enabled_features.core12.bufferDeviceAddress) {
-        optimizer.RegisterPass(CreateInstBuffAddrCheckPass(desc_set_bind_index, unique_shader_module_id));
-    }
-    bool pass = optimizer.Run(new_pgm.data(), new_pgm.size(), &new_pgm, opt_options);
-    std::string instrumented_error;
-    if (!pass) {
-        ReportSetupProblem(device, "Failure to instrument shader.  Proceeding with non-instrumented shader.");
-    } else if (validate_instrumented_shaders &&
-               (!GpuValidateShader(new_pgm, device_extensions.vk_khr_relaxed_block_layout,
-                                   device_extensions.vk_ext_scalar_block_layout, instrumented_error))) {
-        std::ostringstream strm;
-        strm << "Instrumented shader is invalid, error = " << instrumented_error << " Proceeding with non instrumented shader.";
-        ReportSetupProblem(device, strm.str().c_str());
-        pass = false;
-    }
-    *unique_shader_id = unique_shader_module_id++;
-    return pass;
-}
-// Create the instrumented shader data to provide to the driver.
-void GpuAssisted::PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
-                                                  const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
-                                                  void *csm_state_data) {
-    create_shader_module_api_state *csm_state = reinterpret_cast<create_shader_module_api_state *>(csm_state_data);
-    const bool pass = InstrumentShader(vvl::make_span(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)),
-                                       csm_state->instrumented_pgm, &csm_state->unique_shader_id);
-    if (pass) {
-        csm_state->instrumented_create_info.pCode = csm_state->instrumented_pgm.data();
-        csm_state->instrumented_create_info.codeSize = csm_state->instrumented_pgm.size() * sizeof(uint32_t);
-    }
-    ValidationStateTracker::PreCallRecordCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule, csm_state_data);
+    const bool buffer_address_check = (IsExtEnabled(device_extensions.vk_ext_buffer_device_address) ||
+                                       IsExtEnabled(device_extensions.vk_khr_buffer_device_address)) &&
+                                      shaderInt64 && enabled_features.core12.bufferDeviceAddress;
+
+    // Every input of the instrumentation other than the shader id. Checking the instrumented code is part of it, so shaders
+    // cached without the check are instrumented and checked again when it is turned on.
+    std::vector<uint32_t> options = {static_cast<uint32_t>(container_type), desc_set_bind_index, descriptor_indexing,
+                                     buffer_oob_enabled, buffer_address_check, validate_instrumented_shaders};
+    options.insert(options.end(), instrumentation_environment_key.begin(), instrumentation_environment_key.end());
+
+    const auto instrument = [&](uint32_t shader_id) {
+        // Load original shader SPIR-V
+        new_pgm.clear();
+        new_pgm.reserve(input.size());
+        new_pgm.insert(new_pgm.end(), &input.front(), &input.back() + 1);
+
+        Optimizer optimizer(target_env);
+        optimizer.SetMessageConsumer(gpu_console_message_consumer);
+        optimizer.RegisterPass(CreateInstBindlessCheckPass(desc_set_bind_index, shader_id, descriptor_indexing, descriptor_indexing,
+                                                           buffer_oob_enabled, buffer_oob_enabled));
+        // Call CreateAggressiveDCEPass with preserve_interface == true
+        optimizer.RegisterPass(CreateAggressiveDCEPass(true));
+        if (buffer_address_check) {
+            optimizer.RegisterPass(CreateInstBuffAddrCheckPass(desc_set_bind_index, shader_id));
+        }
+        bool pass = optimizer.Run(new_pgm.data(), new_pgm.size(), &new_pgm, opt_options);
+        std::string instrumented_error;
+        if (!pass) {
+            ReportSetupProblem(device, "Failure to instrument shader.  Proceeding with non-instrumented shader.");
+        } else if (validate_instrumented_shaders &&
+                   (!GpuValidateShader(new_pgm, device_extensions.vk_khr_relaxed_block_layout,
+                                       device_extensions.vk_ext_scalar_block_layout, instrumented_error))) {
+            std::ostringstream strm;
+            strm << "Instrumented shader is invalid, error = " << instrumented_error
+                 << " Proceeding with non instrumented shader.";
+            ReportSetupProblem(device, strm.str().c_str());
+            pass = false;
+        }
+        return pass;
+    };
+    return InstrumentShaderCached(input, new_pgm, unique_shader_id, options, instrument);
 }
 
 // Generate the part of the message describing the violation.
@@ -1120,9 +1116,11 @@ bool GenerateValidationMessage(const uint32_t *debug_record, std::string &msg, s
 // sure it is available when the pipeline is submitted.  (The ShaderModule tracking object also
 // keeps a copy, but it can be destroyed after the pipeline is created and before it is submitted.)
 //
-void GpuAssisted::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, GpuAssistedBufferInfo &buffer_info,
-                                             uint32_t operation_index, uint32_t *const debug_output_buffer) {
+void GpuAssisted::AnalyzeAndGenerateMessages(const gpuav_state::CommandBuffer &cb_node, VkQueue queue,
+                                             GpuAssistedBufferInfo &buffer_info, uint32_t operation_index,
+                                             uint32_t *const debug_output_buffer) {
     using namespace spvtools;
+    const VkCommandBuffer command_buffer = cb_node.commandBuffer();
     const uint32_t total_words = debug_output_buffer[kDebugOutputSizeOffset];
     bool oob_access;
     // A zero here means that the shader instrumentation didn't write anything.
@@ -1152,11 +1150,11 @@ void GpuAssisted::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
     const uint32_t *debug_record = &debug_output_buffer[kDebugOutputDataOffset];
     // Lookup the VkShaderModule handle and SPIR-V code used to create the shader, using the unique shader ID value returned
     // by the instrumented shader.
-    auto it = shader_map.find(debug_record[kInstCommonOutShaderId]);
-    if (it != shader_map.end()) {
-        shader_module_handle = it->second.shader_module;
-        pipeline_handle = it->second.pipeline;
-        pgm = it->second.pgm;
+    GpuAssistedShaderTracker shader;
+    if (cb_node.FindShader(debug_record[kInstCommonOutShaderId], shader)) {
+        shader_module_handle = shader.shader_module;
+        pipeline_handle = shader.pipeline;
+        pgm = shader.pgm;
     }
     const bool gen_full_message =
         GenerateValidationMessage(debug_record, validation_message, vuid_msg, oob_access, buffer_info, this);
@@ -1179,12 +1177,14 @@ void GpuAssisted::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
     }
 
     // Clear the written size and any error messages. Note that this preserves the first word, which contains flags.
-    const uint32_t words_to_clear = std::min(total_words, output_buffer_size - kDebugOutputDataOffset);
+    // total_words and kDebugOutputDataOffset count words, output_buffer_size counts bytes
+    const uint32_t words_to_clear =
+        std::min(total_words, output_buffer_size / static_cast<uint32_t>(sizeof(uint32_t)) - kDebugOutputDataOffset);
     debug_output_buffer[kDebugOutputSizeOffset] = 0;
     memset(&debug_output_buffer[kDebugOutputDataOffset], 0, sizeof(uint32_t) * words_to_clear);
 }
 
-// For the given command buffer, map its debug data buffers and read their contents for analysis.
+// For the given command buffer, read the contents of its debug data buffers for analysis.
 void gpuav_state::CommandBuffer::Process(VkQueue queue) {
     auto *device_state = static_cast<GpuAssisted *>(dev_data);
     if (has_draw_cmd || has_trace_rays_cmd || has_dispatch_cmd) {
@@ -1194,8 +1194,6 @@ void gpuav_state::CommandBuffer::Process(VkQueue queue) {
         uint32_t ray_trace_index = 0;
 
         for (auto &buffer_info : gpu_buffer_list) {
-            char *data;
-
             uint32_t operation_index = 0;
             if (buffer_info.pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
                 operation_index = draw_index;
@@ -1210,16 +1208,26 @@ void gpuav_state::CommandBuffer::Process(VkQueue queue) {
                 assert(false);
             }
 
-            VkResult result = vmaMapMemory(device_state->vmaAllocator, buffer_info.output_mem_block.allocation, (void **)&data);
-            if (result == VK_SUCCESS) {
-                device_state->AnalyzeAndGenerateMessages(commandBuffer(), queue, buffer_info, operation_index, (uint32_t *)data);
-                vmaUnmapMemory(device_state->vmaAllocator, buffer_info.output_mem_block.allocation);
+            // Most commands find no error, only look at the records of those that did
+            auto *data = static_cast<uint32_t *>(buffer_info.output_mem_block.data);
+            if (data[spvtools::kDebugOutputSizeOffset] != 0) {
+                device_state->AnalyzeAndGenerateMessages(*this, queue, buffer_info, operation_index, data);
             }
         }
     }
     ProcessAccelerationStructure(queue);
 }
 
+void gpuav_state::CommandBuffer::GetOutputShaderIds(vvl::unordered_set<uint32_t> &shader_ids) const {
+    // The output holds a single record, see GpuAssisted::AnalyzeAndGenerateMessages
+    for (const auto &buffer_info : per_draw_buffer_list) {
+        const auto *data = static_cast<const uint32_t *>(buffer_info.output_mem_block.data);
+        if (data[spvtools::kDebugOutputSizeOffset] != 0) {
+            shader_ids.insert(data[spvtools::kDebugOutputDataOffset + spvtools::kInstCommonOutShaderId]);
+        }
+    }
+}
+
 void GpuAssisted::SetBindingState(uint32_t *data, uint32_t index, const cvdescriptorset::DescriptorBinding *binding) {
     switch (binding->descriptor_class) {
         case cvdescriptorset::DescriptorClass::GeneralBuffer: {
@@ -1289,26 +1297,80 @@ void GpuAssisted::SetBindingState(uint32_t *data, uint32_t index, const cvdescri
     }
 }
 
-// For the given command buffer, map its debug data buffers and update the status of any update after bind descriptors
+// For the given command buffer, update the status of any update after bind descriptors in its debug data buffers
 void GpuAssisted::UpdateInstrumentationBuffer(gpuav_state::CommandBuffer *cb_node) {
-    uint32_t *data;
     for (const auto &buffer_info : cb_node->di_input_buffer_list) {
         if (buffer_info.update_at_submit.size() > 0) {
-            VkResult result = vmaMapMemory(vmaAllocator, buffer_info.allocation, reinterpret_cast<void **>(&data));
-            if (result == VK_SUCCESS) {
-                for (const auto &update : buffer_info.update_at_submit) {
-                    SetBindingState(data, update.first, update.second);
-                }
-                // Flush the descriptor state buffer before unmapping so that the new state is visible to the GPU
-                result = vmaFlushAllocation(vmaAllocator, buffer_info.allocation, 0, VK_WHOLE_SIZE);
-                // No good way to handle this error, we should still try to unmap.
-                assert(result == VK_SUCCESS);
-                vmaUnmapMemory(vmaAllocator, buffer_info.allocation);
+            auto *data = static_cast<uint32_t *>(buffer_info.data);
+            for (const auto &update : buffer_info.update_at_submit) {
+                SetBindingState(data, update.first, update.second);
             }
+            // Flush the descriptor state buffer so that the new state is visible to the GPU
+            VkResult result = cb_node->input_arena.Flush(buffer_info);
+            // No good way to handle this error
+            assert(result == VK_SUCCESS);
+            (void)result;
         }
     }
 }
 
+// Encodes the sizes and write states of the descriptors of a set, to be copied in the input buffer of the command buffer each time
+// the set is bound. They are only encoded again if the set has been updated since.
+const GpuAssistedDescriptorSetInput &GpuAssisted::GetDescriptorSetInput(
+    gpuav_state::CommandBuffer &cb_node, const std::shared_ptr<cvdescriptorset::DescriptorSet> &desc) {
+    auto &cached_input = cb_node.descriptor_set_inputs[desc.get()];
+    const uint64_t change_count = desc->GetChangeCount();
+    if (cached_input && cached_input->change_count == change_count) {
+        return *cached_input;
+    }
+    cached_input = std::make_unique<GpuAssistedDescriptorSetInput>();
+    auto &set_input = *cached_input;
+    set_input.set = desc;
+    set_input.change_count = change_count;
+    set_input.binding_count = desc->GetLayout()->GetMaxBinding() + 1;
+    if (descriptor_indexing) {
+        set_input.sizes.resize(set_input.binding_count, 0);
+    }
+
+    for (const auto &binding : *desc) {
+        const auto written_index = static_cast<uint32_t>(set_input.written.size());
+        set_input.written_offsets.emplace_back(binding->binding, written_index);
+
+        // Shader instrumentation is tracking inline uniform blocks as scalers. Don't try to validate inline uniform blocks
+        if (binding->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+            LogWarning(device, "UNASSIGNED-GPU-Assisted Validation Warning",
+                       "VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT descriptors will not be validated by GPU assisted "
+                       "validation");
+            if (descriptor_indexing) {
+                set_input.sizes[binding->binding] = 1;
+            }
+            set_input.written.push_back(UINT_MAX);
+            continue;
+        }
+
+        if (!set_input.has_buffers && (binding->type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+                                       binding->type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ||
+                                       binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                                       binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                                       binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
+                                       binding->type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)) {
+            set_input.has_buffers = true;
+        }
+
+        set_input.written.resize(written_index + binding->count, 0);
+        if (descriptor_indexing) {
+            set_input.sizes[binding->binding] = binding->count;
+            if ((binding->binding_flags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0) {
+                set_input.update_at_submit.emplace_back(written_index, binding.get());
+                continue;
+            }
+        }
+        // note that VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT is part of descriptor indexing
+        SetBindingState(set_input.written.data(), written_index, binding.get());
+    }
+    return set_input;
+}
+
 void GpuAssisted::UpdateBoundDescriptors(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint) {
     if (aborted) return;
     auto cb_node = GetWrite<gpuav_state::CommandBuffer>(commandBuffer);
@@ -1333,176 +1395,99 @@ void GpuAssisted::UpdateBoundDescriptors(VkCommandBuffer commandBuffer, VkPipeli
         uint32_t descriptor_count = 0;  // Number of descriptors, including all array elements
         uint32_t binding_count = 0;     // Number of bindings based on the max binding number used
 
-        // Figure out how much memory we need for the input block based on how many sets and bindings there are
-        // and how big each of the bindings is
-        for (const auto &s : last_bound.per_set) {
-            auto desc = s.bound_descriptor_set;
+        // The sets are usually bound again and again with few changes, so they are encoded once per version and copied in
+        std::vector<const GpuAssistedDescriptorSetInput *> set_inputs(number_of_sets, nullptr);
+        std::vector<std::pair<const cvdescriptorset::DescriptorSet *, uint64_t>> input_sets(number_of_sets);
+        for (uint32_t set_index = 0; set_index < number_of_sets; ++set_index) {
+            const auto &desc = last_bound.per_set[set_index].bound_descriptor_set;
             if (desc && (desc->GetBindingCount() > 0)) {
-                binding_count += desc->GetLayout()->GetMaxBinding() + 1;
-                for (const auto &binding : *desc) {
-                    // Shader instrumentation is tracking inline uniform blocks as scalers. Don't try to validate inline uniform
-                    // blocks
-                    if (binding->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
-                        descriptor_count++;
-                        LogWarning(device, "UNASSIGNED-GPU-Assisted Validation Warning",
-                                   "VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT descriptors will not be validated by GPU assisted "
-                                   "validation");
-                    } else {
-                        descriptor_count += binding->count;
-                    }
-                    if (!has_buffers && (binding->type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
-                                         binding->type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ||
-                                         binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-                                         binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
-                                         binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER ||
-                                         binding->type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)) {
-                        has_buffers = true;
-                    }
-                }
+                const auto &set_input = GetDescriptorSetInput(*cb_node, desc);
+                set_inputs[set_index] = &set_input;
+                input_sets[set_index] = {desc.get(), set_input.change_count};
+                has_buffers |= set_input.has_buffers;
+                descriptor_count += static_cast<uint32_t>(set_input.written.size());
+                binding_count += set_input.binding_count;
             }
         }
+        // Nothing changed since the last input buffer of the command buffer was written, the draws can keep using it
+        if (cb_node->current_input_buffer.buffer != VK_NULL_HANDLE && input_sets == cb_node->current_input_sets) {
+            return;
+        }
+
         if (descriptor_indexing || has_buffers) {
-            // Note that the size of the input buffer is dependent on the maximum binding number, which
-            // can be very large.  This is because for (set = s, binding = b, index = i), the validation
-            // code is going to dereference Input[ i + Input[ b + Input[ s + Input[ Input[0] ] ] ] ] to
-            // see if descriptors have been written. In gpu_validation.md, we note this and advise
-            // using densely packed bindings as a best practice when using gpu-av with descriptor indexing
             uint32_t words_needed;
             if (descriptor_indexing) {
                 words_needed = 1 + (number_of_sets * 2) + (binding_count * 2) + descriptor_count;
             } else {
                 words_needed = 1 + number_of_sets + binding_count + descriptor_count;
             }
-            VkBufferCreateInfo buffer_info = LvlInitStruct<VkBufferCreateInfo>();
-            buffer_info.size = words_needed * 4;
-            buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-            VmaAllocationCreateInfo alloc_info = {};
-            // The descriptor state buffer can be very large (4mb+ in some games). Allocating it as HOST_CACHED
-            // and manually flushing it at the end of the state updates is faster than using HOST_COHERENT.
-            alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
-            alloc_info.pool = VK_NULL_HANDLE;
             GpuAssistedDeviceMemoryBlock di_input_block = {};
-            VkResult result = vmaCreateBuffer(vmaAllocator, &buffer_info, &alloc_info, &di_input_block.buffer,
-                                              &di_input_block.allocation, nullptr);
+            VkResult result = cb_node->input_arena.Allocate(words_needed * 4, di_input_block);
             if (result != VK_SUCCESS) {
                 ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.", true);
                 aborted = true;
                 return;
             }
-            uint32_t *data_ptr;
-            cb_node->current_input_buffer = di_input_block.buffer;
+            cb_node->current_input_buffer.buffer = di_input_block.buffer;
+            cb_node->current_input_buffer.offset = di_input_block.offset;
+            cb_node->current_input_buffer.range = di_input_block.size;
+            cb_node->current_input_sets = std::move(input_sets);
             // Populate input buffer first with the sizes of every descriptor in every set, then with whether
             // each element of each descriptor has been written or not.  See gpu_validation.md for a more thourough
             // outline of the input buffer format
-            result = vmaMapMemory(vmaAllocator, di_input_block.allocation, reinterpret_cast<void **>(&data_ptr));
-            memset(data_ptr, 0, static_cast<size_t>(buffer_info.size));
+            auto *data_ptr = static_cast<uint32_t *>(di_input_block.data);
+            memset(data_ptr, 0, static_cast<size_t>(di_input_block.size));
 
             // Descriptor indexing needs the number of descriptors at each binding.
-            if (descriptor_indexing) {
-                // Pointer to a sets array that points into the sizes array
-                uint32_t *sets_to_sizes = data_ptr + 1;
-                // Pointer to the sizes array that contains the array size of the descriptor at each binding
-                uint32_t *sizes = sets_to_sizes + number_of_sets;
-                // Pointer to another sets array that points into the bindings array that points into the written array
-                uint32_t *sets_to_bindings = sizes + binding_count;
-                // Pointer to the bindings array that points at the start of the writes in the writes array for each binding
-                uint32_t *bindings_to_written = sets_to_bindings + number_of_sets;
-                // Index of the next entry in the written array to be updated
-                uint32_t written_index = 1 + (number_of_sets * 2) + (binding_count * 2);
-                uint32_t bind_counter = number_of_sets + 1;
-                // Index of the start of the sets_to_bindings array
-                data_ptr[0] = number_of_sets + binding_count + 1;
-
-                for (const auto &s : last_bound.per_set) {
-                    auto desc = s.bound_descriptor_set;
-                    if (desc && (desc->GetBindingCount() > 0)) {
-                        auto layout = desc->GetLayout();
-                        // For each set, fill in index of its bindings sizes in the sizes array
-                        *sets_to_sizes++ = bind_counter;
-                        // For each set, fill in the index of its bindings in the bindings_to_written array
-                        *sets_to_bindings++ = bind_counter + number_of_sets + binding_count;
-                        for (auto &binding : *desc) {
-                            // For each binding, fill in its size in the sizes array
-                            // Shader instrumentation is tracking inline uniform blocks as scalers. Don't try to validate inline
-                            // uniform blocks
-                            if (VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT == binding->type) {
-                                sizes[binding->binding] = 1;
-                            } else {
-                                sizes[binding->binding] = binding->count;
-                            }
-                            // Fill in the starting index for this binding in the written array in the bindings_to_written array
-                            bindings_to_written[binding->binding] = written_index;
-
-                            // Shader instrumentation is tracking inline uniform blocks as scalers. Don't try to validate inline
-                            // uniform blocks
-                            if (VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT == binding->type) {
-                                data_ptr[written_index++] = UINT_MAX;
-                                continue;
-                            }
-
-                            if ((binding->binding_flags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0) {
-                                di_input_block.update_at_submit[written_index] = binding.get();
-                            } else {
-                                SetBindingState(data_ptr, written_index, binding.get());
-                            }
-                            written_index += binding->count;
-                        }
-                        auto last = desc->GetLayout()->GetMaxBinding();
-                        bindings_to_written += last + 1;
-                        bind_counter += last + 1;
-                        sizes += last + 1;
-                    } else {
+            // If no descriptor indexing, we don't need number of descriptors at each binding, so
+            // no sets_to_sizes or sizes arrays, just sets_to_bindings, bindings_to_written and written_index
+            const uint32_t size_arrays_words = descriptor_indexing ? (number_of_sets + binding_count) : 0;
+            // Pointer to a sets array that points into the sizes array
+            uint32_t *sets_to_sizes = data_ptr + 1;
+            // Pointer to another sets array that points into the bindings array that points into the written array
+            uint32_t *sets_to_bindings = data_ptr + 1 + size_arrays_words;
+            // Index of the start of the bindings of the current set, in the sizes array if there is one, else in the bindings
+            // array that points at the start of the writes in the writes array for each binding
+            uint32_t bind_counter = number_of_sets + 1;
+            // Offset from the sizes of a binding to the start of its writes in the bindings array
+            const uint32_t bindings_to_written_offset = descriptor_indexing ? (number_of_sets + binding_count) : 0;
+            // Index of the next entry in the written array to be updated
+            uint32_t written_index = 1 + number_of_sets + binding_count + size_arrays_words;
+            // Index of the start of the sets_to_bindings array
+            data_ptr[0] = descriptor_indexing ? number_of_sets + binding_count + 1 : 1;
+
+            for (const auto *set_input : set_inputs) {
+                if (!set_input) {
+                    if (descriptor_indexing) {
                         *sets_to_sizes++ = 0;
-                        *sets_to_bindings++ = 0;
                     }
+                    *sets_to_bindings++ = 0;
+                    continue;
                 }
-            } else {
-                // If no descriptor indexing, we don't need number of descriptors at each binding, so
-                // no sets_to_sizes or sizes arrays, just sets_to_bindings, bindings_to_written and written_index
-
-                // Pointer to sets array that points into the bindings array that points into the written array
-                uint32_t *sets_to_bindings = data_ptr + 1;
-                // Pointer to the bindings array that points at the start of the writes in the writes array for each binding
-                uint32_t *bindings_to_written = sets_to_bindings + number_of_sets;
-                // Index of the next entry in the written array to be updated
-                uint32_t written_index = 1 + number_of_sets + binding_count;
-                uint32_t bind_counter = number_of_sets + 1;
-                data_ptr[0] = 1;
-
-                for (const auto &s : last_bound.per_set) {
-                    auto desc = s.bound_descriptor_set;
-                    if (desc && (desc->GetBindingCount() > 0)) {
-                        auto layout = desc->GetLayout();
-                        *sets_to_bindings++ = bind_counter;
-                        for (auto &binding : *desc) {
-                            // Fill in the starting index for this binding in the written array in the bindings_to_written array
-                            bindings_to_written[binding->binding] = written_index;
-
-                            // Shader instrumentation is tracking inline uniform blocks as scalers. Don't try to validate inline
-                            // uniform blocks
-                            if (VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT == binding->type) {
-                                data_ptr[written_index++] = UINT_MAX;
-                                continue;
-                            }
-
-                            // note that VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT is part of descriptor indexing
-                            SetBindingState(data_ptr, written_index, binding.get());
-                            written_index += binding->count;
-                        }
-                        auto last = desc->GetLayout()->GetMaxBinding();
-                        bindings_to_written += last + 1;
-                        bind_counter += last + 1;
-                    } else {
-                        *sets_to_bindings++ = 0;
-                    }
+                if (descriptor_indexing) {
+                    // For each set, fill in index of its bindings sizes in the sizes array
+                    *sets_to_sizes++ = bind_counter;
+                    std::copy(set_input->sizes.begin(), set_input->sizes.end(), data_ptr + bind_counter);
+                }
+                // For each set, fill in the index of its bindings in the bindings_to_written array
+                *sets_to_bindings++ = bind_counter + bindings_to_written_offset;
+                for (const auto &written_offset : set_input->written_offsets) {
+                    // Fill in the starting index for this binding in the written array in the bindings_to_written array
+                    data_ptr[bind_counter + bindings_to_written_offset + written_offset.first] =
+                        written_index + written_offset.second;
+                }
+                std::copy(set_input->written.begin(), set_input->written.end(), data_ptr + written_index);
+                for (const auto &update : set_input->update_at_submit) {
+                    di_input_block.update_at_submit[written_index + update.first] = update.second;
                 }
+                written_index += static_cast<uint32_t>(set_input->written.size());
+                bind_counter += set_input->binding_count;
             }
-            // Flush the descriptor state buffer before unmapping so that the new state is visible to the GPU
-            result = vmaFlushAllocation(vmaAllocator, di_input_block.allocation, 0, VK_WHOLE_SIZE);
-            // No good way to handle this error, we should still try to unmap.
+            // Flush the descriptor state buffer so that the new state is visible to the GPU
+            result = cb_node->input_arena.Flush(di_input_block);
+            // No good way to handle this error
             assert(result == VK_SUCCESS);
-            vmaUnmapMemory(vmaAllocator, di_input_block.allocation);
-            cb_node->di_input_buffer_list.emplace_back(di_input_block);
+            cb_node->di_input_buffer_list.emplace_back(std::move(di_input_block));
         }
     }
 }
@@ -1535,7 +1520,7 @@ void GpuAssisted::PreRecordCommandBuffer(VkCommandBuffer command_buffer) {
 }
 
 void GpuAssisted::PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence) {
-    ValidationStateTracker::PreCallRecordQueueSubmit(queue, submitCount, pSubmits, fence);
+    GpuAssistedBase::PreCallRecordQueueSubmit(queue, submitCount, pSubmits, fence);
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo *submit = &pSubmits[submit_idx];
         for (uint32_t i = 0; i < submit->commandBufferCount; i++) {
@@ -1546,7 +1531,7 @@ void GpuAssisted::PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount,
 
 void GpuAssisted::PreCallRecordQueueSubmit2KHR(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2KHR *pSubmits,
                                                VkFence fence) {
-    ValidationStateTracker::PreCallRecordQueueSubmit2KHR(queue, submitCount, pSubmits, fence);
+    GpuAssistedBase::PreCallRecordQueueSubmit2KHR(queue, submitCount, pSubmits, fence);
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo2KHR *submit = &pSubmits[submit_idx];
         for (uint32_t i = 0; i < submit->commandBufferInfoCount; i++) {
@@ -1556,6 +1541,7 @@ void GpuAssisted::PreCallRecordQueueSubmit2KHR(VkQueue queue, uint32_t submitCou
 }
 
 void GpuAssisted::PreCallRecordQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2 *pSubmits, VkFence fence) {
+    GpuAssistedBase::PreCallRecordQueueSubmit2(queue, submitCount, pSubmits, fence);
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo2 *submit = &pSubmits[submit_idx];
         for (uint32_t i = 0; i < submit->commandBufferInfoCount; i++) {
@@ -1879,8 +1865,8 @@ void GpuAssisted::AllocatePreDrawValidationResources(const GpuAssistedDeviceMemo
     VkDescriptorBufferInfo buffer_infos[buffer_count] = {};
     // Error output buffer
     buffer_infos[0].buffer = output_block.buffer;
-    buffer_infos[0].offset = 0;
-    buffer_infos[0].range = VK_WHOLE_SIZE;
+    buffer_infos[0].offset = output_block.offset;
+    buffer_infos[0].range = output_block.size;
     if (indirect_state->count_buffer) {
         // Count buffer
         buffer_infos[1].buffer = indirect_state->count_buffer;
@@ -1978,8 +1964,8 @@ void GpuAssisted::AllocatePreDispatchValidationResources(const GpuAssistedDevice
     VkDescriptorBufferInfo buffer_infos[buffer_count] = {};
     // Error output buffer
     buffer_infos[0].buffer = output_block.buffer;
-    buffer_infos[0].offset = 0;
-    buffer_infos[0].range = VK_WHOLE_SIZE;
+    buffer_infos[0].offset = output_block.offset;
+    buffer_infos[0].range = output_block.size;
     buffer_infos[1].buffer = indirect_state->buffer;
     buffer_infos[1].offset = 0;
     buffer_infos[1].range = VK_WHOLE_SIZE;
@@ -2038,33 +2024,22 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
 
     // Allocate memory for the output block that the gpu will use to return any error information
     GpuAssistedDeviceMemoryBlock output_block = {};
-    VkBufferCreateInfo buffer_info = LvlInitStruct<VkBufferCreateInfo>();
-    buffer_info.size = output_buffer_size;
-    buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    VmaAllocationCreateInfo alloc_info = {};
-    alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    alloc_info.pool = output_buffer_pool;
-    result = vmaCreateBuffer(vmaAllocator, &buffer_info, &alloc_info, &output_block.buffer, &output_block.allocation, nullptr);
+    result = cb_node->output_arena.Allocate(output_buffer_size, output_block);
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.", true);
         aborted = true;
         return;
     }
 
-    uint32_t *data_ptr;
-    result = vmaMapMemory(vmaAllocator, output_block.allocation, reinterpret_cast<void **>(&data_ptr));
-    if (result == VK_SUCCESS) {
-        memset(data_ptr, 0, output_buffer_size);
-        if (buffer_oob_enabled || buffer_device_address) {
-            uses_robustness =
-                (enabled_features.core.robustBufferAccess || enabled_features.robustness2_features.robustBufferAccess2 ||
-                 pipeline_state->uses_pipeline_robustness);
-            data_ptr[spvtools::kDebugOutputFlagsOffset] = spvtools::kInstBufferOOBEnable;
-        }
-        vmaUnmapMemory(vmaAllocator, output_block.allocation);
+    auto *data_ptr = static_cast<uint32_t *>(output_block.data);
+    memset(data_ptr, 0, output_buffer_size);
+    if (buffer_oob_enabled || buffer_device_address) {
+        uses_robustness = (enabled_features.core.robustBufferAccess || enabled_features.robustness2_features.robustBufferAccess2 ||
+                           pipeline_state->uses_pipeline_robustness);
+        data_ptr[spvtools::kDebugOutputFlagsOffset] = spvtools::kInstBufferOOBEnable;
     }
 
-    GpuAssistedDeviceMemoryBlock bda_input_block = {};
+    std::shared_ptr<const GpuAssistedBufferAddressTable> bda_input_table;
     VkDescriptorBufferInfo di_input_desc_buffer_info = {};
     VkDescriptorBufferInfo bda_input_desc_buffer_info = {};
     VkWriteDescriptorSet desc_writes[3] = {};
@@ -2191,10 +2166,8 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         restorable_state.Restore(cmd_buffer);
     }
 
-    if (cb_node->current_input_buffer != VK_NULL_HANDLE) {
-        di_input_desc_buffer_info.range = VK_WHOLE_SIZE;
-        di_input_desc_buffer_info.buffer = cb_node->current_input_buffer;
-        di_input_desc_buffer_info.offset = 0;
+    if (cb_node->current_input_buffer.buffer != VK_NULL_HANDLE) {
+        di_input_desc_buffer_info = cb_node->current_input_buffer;
 
         desc_writes[desc_count] = LvlInitStruct<VkWriteDescriptorSet>();
         desc_writes[desc_count].dstBinding = 1;
@@ -2206,56 +2179,15 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
     }
 
     if (buffer_device_address) {
-        auto address_ranges = GetBufferAddressRanges();
-        if (address_ranges.size() > 0) {
-            // Example BDA input buffer assuming 2 buffers using BDA:
-            // Word 0 | Index of start of buffer sizes (in this case 5)
-            // Word 1 | 0x0000000000000000
-            // Word 2 | Device Address of first buffer  (Addresses sorted in ascending order)
-            // Word 3 | Device Address of second buffer
-            // Word 4 | 0xffffffffffffffff
-            // Word 5 | 0 (size of pretend buffer at word 1)
-            // Word 6 | Size in bytes of first buffer
-            // Word 7 | Size in bytes of second buffer
-            // Word 8 | 0 (size of pretend buffer in word 4)
-
-            uint32_t num_buffers = static_cast<uint32_t>(address_ranges.size());
-            uint32_t words_needed = (num_buffers + 3) + (num_buffers + 2);
-            buffer_info.size = words_needed * 8;  // 64 bit words
-            alloc_info.pool = VK_NULL_HANDLE;
-            // This buffer could be very large if an application uses many buffers. Allocating it as HOST_CACHED
-            // and manually flushing it at the end of the state updates is faster than using HOST_COHERENT.
-            alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
-            result = vmaCreateBuffer(vmaAllocator, &buffer_info, &alloc_info, &bda_input_block.buffer, &bda_input_block.allocation,
-                                     nullptr);
-            if (result != VK_SUCCESS) {
-                ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.", true);
-                aborted = true;
-                return;
-            }
-            uint64_t *bda_data;
-            result = vmaMapMemory(vmaAllocator, bda_input_block.allocation, reinterpret_cast<void **>(&bda_data));
-            uint32_t address_index = 1;
-            uint32_t size_index = 3 + num_buffers;
-            memset(bda_data, 0, static_cast<size_t>(buffer_info.size));
-            bda_data[0] = size_index;       // Start of buffer sizes
-            bda_data[address_index++] = 0;  // NULL address
-            bda_data[size_index++] = 0;
-
-            for (const auto &range : address_ranges) {
-                bda_data[address_index++] = range.begin;
-                bda_data[size_index++] = range.end - range.begin;
-            }
-            bda_data[address_index] = std::numeric_limits<uintptr_t>::max();
-            bda_data[size_index] = 0;
-            // Flush the BDA buffer before unmapping so that the new state is visible to the GPU
-            result = vmaFlushAllocation(vmaAllocator, bda_input_block.allocation, 0, VK_WHOLE_SIZE);
-            // No good way to handle this error, we should still try to unmap.
-            assert(result == VK_SUCCESS);
-            vmaUnmapMemory(vmaAllocator, bda_input_block.allocation);
-
-            bda_input_desc_buffer_info.range = (words_needed * 8);
-            bda_input_desc_buffer_info.buffer = bda_input_block.buffer;
+        bda_input_table = GetBufferAddressTable();
+        if (!bda_input_table) {
+            ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.", true);
+            aborted = true;
+            return;
+        }
+        if (bda_input_table->buffer != VK_NULL_HANDLE) {
+            bda_input_desc_buffer_info.range = bda_input_table->size;
+            bda_input_desc_buffer_info.buffer = bda_input_table->buffer;
             bda_input_desc_buffer_info.offset = 0;
 
             desc_writes[desc_count] = LvlInitStruct<VkWriteDescriptorSet>();
@@ -2270,7 +2202,7 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
 
     // Write the descriptor
     output_desc_buffer_info.buffer = output_block.buffer;
-    output_desc_buffer_info.offset = 0;
+    output_desc_buffer_info.offset = output_block.offset;
 
     desc_writes[0] = LvlInitStruct<VkWriteDescriptorSet>();
     desc_writes[0].descriptorCount = 1;
@@ -2299,33 +2231,111 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
     if (pipeline_layout_handle == VK_NULL_HANDLE) {
         ReportSetupProblem(device, "Unable to find pipeline layout to bind debug descriptor set. Aborting GPU-AV");
         aborted = true;
-        vmaDestroyBuffer(vmaAllocator, bda_input_block.buffer, bda_input_block.allocation);
-        vmaDestroyBuffer(vmaAllocator, output_block.buffer, output_block.allocation);
     } else {
         // Record buffer and memory info in CB state tracking
-        cb_node->per_draw_buffer_list.emplace_back(output_block, bda_input_block, pre_draw_resources, pre_dispatch_resources,
+        cb_node->per_draw_buffer_list.emplace_back(output_block, std::move(bda_input_table), pre_draw_resources,
+                                                   pre_dispatch_resources,
                                                    desc_sets[0], desc_pool, bind_point, uses_robustness, cmd_type);
     }
 }
 
+std::shared_ptr<const GpuAssistedBufferAddressTable> GpuAssisted::GetBufferAddressTable() {
+    std::lock_guard<std::mutex> guard(buffer_address_table_lock);
+    if (buffer_address_table && buffer_address_table->generation == BufferAddressGeneration()) {
+        return buffer_address_table;
+    }
+
+    uint64_t generation;
+    const auto address_ranges = GetBufferAddressRanges(generation);
+    auto table = std::make_shared<GpuAssistedBufferAddressTable>(vmaAllocator, generation);
+    if (address_ranges.size() > 0) {
+        // Example BDA input buffer assuming 2 buffers using BDA:
+        // Word 0 | Index of start of buffer sizes (in this case 5)
+        // Word 1 | 0x0000000000000000
+        // Word 2 | Device Address of first buffer  (Addresses sorted in ascending order)
+        // Word 3 | Device Address of second buffer
+        // Word 4 | 0xffffffffffffffff
+        // Word 5 | 0 (size of pretend buffer at word 1)
+        // Word 6 | Size in bytes of first buffer
+        // Word 7 | Size in bytes of second buffer
+        // Word 8 | 0 (size of pretend buffer in word 4)
+
+        uint32_t num_buffers = static_cast<uint32_t>(address_ranges.size());
+        uint32_t words_needed = (num_buffers + 3) + (num_buffers + 2);
+        VkBufferCreateInfo buffer_info = LvlInitStruct<VkBufferCreateInfo>();
+        buffer_info.size = words_needed * 8;  // 64 bit words
+        buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        VmaAllocationCreateInfo alloc_info = {};
+        // This buffer could be very large if an application uses many buffers. Allocating it as HOST_CACHED
+        // and manually flushing it at the end of the state updates is faster than using HOST_COHERENT.
+        alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        VkResult result = vmaCreateBuffer(vmaAllocator, &buffer_info, &alloc_info, &table->buffer, &table->allocation, nullptr);
+        if (result != VK_SUCCESS) {
+            return nullptr;
+        }
+        table->size = buffer_info.size;
+
+        uint64_t *bda_data;
+        result = vmaMapMemory(vmaAllocator, table->allocation, reinterpret_cast<void **>(&bda_data));
+        if (result != VK_SUCCESS) {
+            return nullptr;
+        }
+        uint32_t address_index = 1;
+        uint32_t size_index = 3 + num_buffers;
+        memset(bda_data, 0, static_cast<size_t>(buffer_info.size));
+        bda_data[0] = size_index;       // Start of buffer sizes
+        bda_data[address_index++] = 0;  // NULL address
+        bda_data[size_index++] = 0;
+
+        for (const auto &range : address_ranges) {
+            bda_data[address_index++] = range.begin;
+            bda_data[size_index++] = range.end - range.begin;
+        }
+        bda_data[address_index] = std::numeric_limits<uintptr_t>::max();
+        bda_data[size_index] = 0;
+        // Flush the BDA buffer before unmapping so that the new state is visible to the GPU
+        result = vmaFlushAllocation(vmaAllocator, table->allocation, 0, VK_WHOLE_SIZE);
+        // No good way to handle this error, we should still try to unmap.
+        assert(result == VK_SUCCESS);
+        vmaUnmapMemory(vmaAllocator, table->allocation);
+    }
+    // The command buffers using the previous table keep it alive until they are reset
+    buffer_address_table = std::move(table);
+    return buffer_address_table;
+}
+
 std::shared_ptr<CMD_BUFFER_STATE> GpuAssisted::CreateCmdBufferState(VkCommandBuffer cb,
                                                                     const VkCommandBufferAllocateInfo *pCreateInfo,
                                                                     const COMMAND_POOL_STATE *pool) {
     return std::static_pointer_cast<CMD_BUFFER_STATE>(std::make_shared<gpuav_state::CommandBuffer>(this, cb, pCreateInfo, pool));
 }
 
+// The input blocks can be very large (4mb+ in some games), larger allocations get a VMA buffer of their own
+static constexpr VkDeviceSize kInputArenaBlockSize = 1024 * 1024;
+
 gpuav_state::CommandBuffer::CommandBuffer(GpuAssisted *ga, VkCommandBuffer cb, const VkCommandBufferAllocateInfo *pCreateInfo,
                                           const COMMAND_POOL_STATE *pool)
-    : gpu_utils_state::CommandBuffer(ga, cb, pCreateInfo, pool) {}
+    : gpu_utils_state::CommandBuffer(ga, cb, pCreateInfo, pool),
+      output_arena(ga->vmaAllocator, ga->output_buffer_pool,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                   ga->phys_dev_props.limits.minStorageBufferOffsetAlignment, kOutputArenaBlockSize),
+      // The input blocks are written from the host once and read by the device. Allocating them as HOST_CACHED and manually
+      // flushing them at the end of the state updates is faster than using HOST_COHERENT.
+      input_arena(ga->vmaAllocator, VK_NULL_HANDLE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+                  ga->phys_dev_props.limits.minStorageBufferOffsetAlignment, kInputArenaBlockSize) {}
 
 gpuav_state::CommandBuffer::~CommandBuffer() { Destroy(); }
 
 void gpuav_state::CommandBuffer::Destroy() {
+    WaitForProcessing();
     ResetCBState();
+    output_arena.Destroy();
+    input_arena.Destroy();
     CMD_BUFFER_STATE::Destroy();
 }
 
 void gpuav_state::CommandBuffer::Reset() {
+    WaitForProcessing();
     CMD_BUFFER_STATE::Reset();
     ResetCBState();
 }
@@ -2338,11 +2348,12 @@ void gpuav_state::CommandBuffer::ResetCBState() {
     }
     per_draw_buffer_list.clear();
 
-    for (auto &buffer_info : di_input_buffer_list) {
-        vmaDestroyBuffer(gpuav->vmaAllocator, buffer_info.buffer, buffer_info.allocation);
-    }
     di_input_buffer_list.clear();
-    current_input_buffer = VK_NULL_HANDLE;
+    current_input_buffer = {};
+    current_input_sets.clear();
+    descriptor_set_inputs.clear();
+    output_arena.Reset();
+    input_arena.Reset();
 
     for (auto &as_validation_buffer_info : as_validation_buffers) {
         gpuav->DestroyBuffer(as_validation_buffer_info);
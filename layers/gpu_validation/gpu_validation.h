@@ -22,12 +22,31 @@
 
 class GpuAssisted;
 
-struct GpuAssistedDeviceMemoryBlock {
-    VkBuffer buffer;
-    VmaAllocation allocation;
+struct GpuAssistedDeviceMemoryBlock : public GpuAssistedBufferRange {
     vvl::unordered_map<uint32_t, const cvdescriptorset::DescriptorBinding*> update_at_submit;
 };
 
+// Sorted addresses and sizes of the buffers with a device address, read by the instrumented shaders. There is one table per
+// generation of the address ranges (see ValidationStateTracker::BufferAddressGeneration), shared by all the draws recorded while it
+// is current. Command buffers keep the tables they use alive, so pending submissions keep reading the ranges they were recorded
+// with when a new generation replaces it.
+struct GpuAssistedBufferAddressTable {
+    GpuAssistedBufferAddressTable(VmaAllocator allocator, uint64_t generation) : allocator(allocator), generation(generation) {}
+    GpuAssistedBufferAddressTable(const GpuAssistedBufferAddressTable&) = delete;
+    GpuAssistedBufferAddressTable& operator=(const GpuAssistedBufferAddressTable&) = delete;
+    ~GpuAssistedBufferAddressTable() {
+        if (buffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(allocator, buffer, allocation);
+        }
+    }
+
+    const VmaAllocator allocator;
+    const uint64_t generation;
+    VkBuffer buffer = VK_NULL_HANDLE;  // VK_NULL_HANDLE if there are no address ranges
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+};
+
 struct GpuAssistedPreDrawResources {
     VkDescriptorPool desc_pool = VK_NULL_HANDLE;
     VkDescriptorSet desc_set = VK_NULL_HANDLE;
@@ -48,7 +67,7 @@ struct GpuAssistedPreDispatchResources {
 
 struct GpuAssistedBufferInfo {
     GpuAssistedDeviceMemoryBlock output_mem_block;
-    GpuAssistedDeviceMemoryBlock bda_input_mem_block;  // Buffer Device Address input
+    std::shared_ptr<const GpuAssistedBufferAddressTable> bda_input_table;  // Buffer Device Address input
     GpuAssistedPreDrawResources pre_draw_resources;
     GpuAssistedPreDispatchResources pre_dispatch_resources;
     VkDescriptorSet desc_set;
@@ -56,12 +75,13 @@ struct GpuAssistedBufferInfo {
     VkPipelineBindPoint pipeline_bind_point;
     bool uses_robustness;
     CMD_TYPE cmd_type;
-    GpuAssistedBufferInfo(GpuAssistedDeviceMemoryBlock output_mem_block, GpuAssistedDeviceMemoryBlock bda_input_mem_block,
+    GpuAssistedBufferInfo(GpuAssistedDeviceMemoryBlock output_mem_block,
+                          std::shared_ptr<const GpuAssistedBufferAddressTable> bda_input_table,
                           GpuAssistedPreDrawResources pre_draw_resources, GpuAssistedPreDispatchResources pre_dispatch_resources,
                           VkDescriptorSet desc_set, VkDescriptorPool desc_pool, VkPipelineBindPoint pipeline_bind_point,
                           bool uses_robustness, CMD_TYPE cmd_type)
         : output_mem_block(output_mem_block),
-          bda_input_mem_block(bda_input_mem_block),
+          bda_input_table(std::move(bda_input_table)),
           pre_draw_resources(pre_draw_resources),
           pre_dispatch_resources(pre_dispatch_resources),
           desc_set(desc_set),
@@ -71,6 +91,18 @@ struct GpuAssistedBufferInfo {
           cmd_type(cmd_type){};
 };
 
+// The part of the descriptor indexing input buffer describing one descriptor set, see GpuAssisted::GetDescriptorSetInput
+struct GpuAssistedDescriptorSetInput {
+    std::shared_ptr<cvdescriptorset::DescriptorSet> set;
+    uint64_t change_count = 0;  // of set, when it was encoded
+    uint32_t binding_count = 0;  // max binding number + 1
+    bool has_buffers = false;
+    std::vector<uint32_t> sizes;  // descriptor count of each binding number, only with descriptor indexing
+    std::vector<std::pair<uint32_t, uint32_t>> written_offsets;  // binding number, index of its first descriptor in written
+    std::vector<uint32_t> written;  // write state of each descriptor
+    std::vector<std::pair<uint32_t, const cvdescriptorset::DescriptorBinding*>> update_at_submit;  // index in written, binding
+};
+
 struct GpuVuid {
     const char* uniform_access_oob = kVUIDUndefined;
     const char* storage_access_oob = kVUIDUndefined;
@@ -151,7 +183,12 @@ class CommandBuffer : public gpu_utils_state::CommandBuffer {
     std::vector<GpuAssistedBufferInfo> per_draw_buffer_list;
     std::vector<GpuAssistedDeviceMemoryBlock> di_input_buffer_list;
     std::vector<GpuAssistedAccelerationStructureBuildValidationBufferInfo> as_validation_buffers;
-    VkBuffer current_input_buffer = VK_NULL_HANDLE;
+    VkDescriptorBufferInfo current_input_buffer = {};
+    // Sets and versions current_input_buffer was written with
+    std::vector<std::pair<const cvdescriptorset::DescriptorSet*, uint64_t>> current_input_sets;
+    vvl::unordered_map<const cvdescriptorset::DescriptorSet*, std::unique_ptr<GpuAssistedDescriptorSetInput>> descriptor_set_inputs;
+    GpuAssistedBufferArena output_arena;
+    GpuAssistedBufferArena input_arena;
 
     CommandBuffer(GpuAssisted* ga, VkCommandBuffer cb, const VkCommandBufferAllocateInfo* pCreateInfo,
                   const COMMAND_POOL_STATE* pool);
@@ -159,6 +196,7 @@ class CommandBuffer : public gpu_utils_state::CommandBuffer {
 
     bool NeedsProcessing() const final { return !per_draw_buffer_list.empty() || has_build_as_cmd; }
     void Process(VkQueue queue) final;
+    void GetOutputShaderIds(vvl::unordered_set<uint32_t>& shader_ids) const final;
 
     void Destroy() final;
     void Reset() final;
@@ -196,14 +234,13 @@ class GpuAssisted : public GpuAssistedBase {
                                                       VkBuffer scratch, VkDeviceSize scratchOffset) override;
     void PreCallRecordDestroyRenderPass(VkDevice device, VkRenderPass renderPass, const VkAllocationCallbacks* pAllocator) override;
     bool InstrumentShader(const vvl::span<const uint32_t>& input, std::vector<uint32_t>& new_pgm,
-                          uint32_t* unique_shader_id) override;
-    void PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
-                                         const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule,
-                                         void* csm_state_data) override;
-    void AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, GpuAssistedBufferInfo& buffer_info,
+                          uint32_t unique_shader_id) override;
+    void AnalyzeAndGenerateMessages(const gpuav_state::CommandBuffer& cb_node, VkQueue queue, GpuAssistedBufferInfo& buffer_info,
                                     uint32_t operation_index, uint32_t* const debug_output_buffer);
 
     void SetBindingState(uint32_t* data, uint32_t index, const cvdescriptorset::DescriptorBinding* binding);
+    const GpuAssistedDescriptorSetInput& GetDescriptorSetInput(gpuav_state::CommandBuffer& cb_node,
+                                                               const std::shared_ptr<cvdescriptorset::DescriptorSet>& desc);
     void UpdateInstrumentationBuffer(gpuav_state::CommandBuffer* cb_node);
 
     void UpdateBoundDescriptors(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint);
@@ -309,6 +346,7 @@ class GpuAssisted : public GpuAssistedBase {
   private:
     void PreRecordCommandBuffer(VkCommandBuffer command_buffer);
     VkPipeline GetValidationPipeline(VkRenderPass render_pass);
+    std::shared_ptr<const GpuAssistedBufferAddressTable> GetBufferAddressTable();
 
     VkBool32 shaderInt64;
     bool buffer_oob_enabled;
@@ -319,6 +357,8 @@ class GpuAssisted : public GpuAssistedBase {
     GpuAssistedAccelerationStructureBuildValidationState acceleration_structure_validation_state;
     GpuAssistedPreDrawValidationState pre_draw_validation_state;
     GpuAssistedPreDispatchValidationState pre_dispatch_validation_state;
+    std::mutex buffer_address_table_lock;
+    std::shared_ptr<const GpuAssistedBufferAddressTable> buffer_address_table;
 
     bool descriptor_indexing = false;
     bool buffer_device_address;
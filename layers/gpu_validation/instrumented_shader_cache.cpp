@@ -0,0 +1,215 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gpu_validation/instrumented_shader_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <spirv/unified1/spirv.hpp>
+#include "external/xxhash.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+std::atomic<uint32_t> InstrumentedShaderCache::save_count_{0};
+
+// magic, version, tools key, entry count and checksum
+static constexpr size_t kFileOverhead = (4 + std::tuple_size<InstrumentedShaderCache::Key>::value) * sizeof(uint32_t);
+
+InstrumentedShaderCache::Key InstrumentedShaderCache::ToolsKey() {
+    return ValidationCache::KeyBuilder().Add(SPIRV_TOOLS_COMMIT_ID, std::strlen(SPIRV_TOOLS_COMMIT_ID)).Get();
+}
+
+InstrumentedShaderCache::Key InstrumentedShaderCache::MakeKey(vvl::span<const uint32_t> code,
+                                                              const std::vector<uint32_t> &options) {
+    return ValidationCache::KeyBuilder()
+        .Add(options.data(), options.size() * sizeof(uint32_t))
+        .Add(code.data(), code.size() * sizeof(uint32_t))
+        .Get();
+}
+
+bool InstrumentedShaderCache::CanCache(vvl::span<const uint32_t> code) {
+    return std::find(code.begin(), code.end(), kShaderIdPlaceholder) == code.end();
+}
+
+bool InstrumentedShaderCache::Find(const Key &key, uint32_t shader_id, std::vector<uint32_t> &instrumented) const {
+    std::lock_guard<std::mutex> guard(lock_);
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return false;
+    }
+    instrumented = it->second.code;
+    if (it->second.shader_id_offset != 0) {
+        instrumented[it->second.shader_id_offset] = shader_id;
+    }
+    return true;
+}
+
+bool InstrumentedShaderCache::Add(const Key &key, std::vector<uint32_t> &instrumented, uint32_t shader_id) {
+    // The passes get the shader id through a uint OpConstant, which is the only place the placeholder may appear. If nothing was
+    // instrumented, there is no shader id in the code at all.
+    const size_t placeholder_count = std::count(instrumented.begin(), instrumented.end(), kShaderIdPlaceholder);
+    if (placeholder_count > 1) {
+        return false;
+    }
+    uint32_t shader_id_offset = 0;
+    for (size_t offset = 5; placeholder_count == 1 && offset < instrumented.size();) {
+        const uint32_t length = instrumented[offset] >> 16;
+        if (length == 0) {
+            return false;
+        }
+        if ((instrumented[offset] & 0xFFFFu) == spv::OpConstant && length == 4 && offset + 3 < instrumented.size() &&
+            instrumented[offset + 3] == kShaderIdPlaceholder) {
+            shader_id_offset = static_cast<uint32_t>(offset + 3);
+            break;
+        }
+        offset += length;
+    }
+    if (placeholder_count == 1 && shader_id_offset == 0) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        // key, shader id offset, word count, code
+        const size_t entry_size = (std::tuple_size<Key>::value + 2 + instrumented.size()) * sizeof(uint32_t);
+        if (entries_.find(key) == entries_.end() && kFileOverhead + size_ + entry_size <= kMaxFileSize) {
+            entries_.emplace(key, Entry{instrumented, shader_id_offset});
+            size_ += entry_size;
+            dirty_ = true;
+        }
+    }
+    if (shader_id_offset != 0) {
+        instrumented[shader_id_offset] = shader_id;
+    }
+    return true;
+}
+
+bool InstrumentedShaderCache::Load() {
+    std::ifstream file(path_, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    const std::streamoff file_size = file.tellg();
+    if (file_size <= 0 || static_cast<uint64_t>(file_size) > kMaxFileSize || file_size % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    std::vector<uint32_t> words(static_cast<size_t>(file_size) / sizeof(uint32_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(words.data()), file_size)) {
+        return false;
+    }
+
+    const Key tools_key = ToolsKey();
+    const size_t header_size = 3 + tools_key.size();  // magic, version, tools key, entry count
+    if (words.size() < header_size + 1 || words[0] != kFileMagic || words[1] != kFileVersion ||
+        !std::equal(tools_key.begin(), tools_key.end(), words.begin() + 2)) {
+        return false;
+    }
+    const size_t checksum_offset = words.size() - 1;
+    if (XXH32(words.data(), checksum_offset * sizeof(uint32_t), 0) != words[checksum_offset]) {
+        return false;
+    }
+
+    const uint32_t entry_count = words[header_size - 1];
+    decltype(entries_) entries;
+    size_t offset = header_size;
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        // key, shader id offset, word count
+        if (checksum_offset - offset < std::tuple_size<Key>::value + 2) {
+            return false;
+        }
+        Key key;
+        std::copy_n(words.begin() + offset, key.size(), key.begin());
+        offset += key.size();
+        const uint32_t shader_id_offset = words[offset++];
+        const uint32_t word_count = words[offset++];
+        if (checksum_offset - offset < word_count || shader_id_offset >= word_count) {
+            return false;
+        }
+        entries[key] = Entry{std::vector<uint32_t>(words.begin() + offset, words.begin() + offset + word_count), shader_id_offset};
+        offset += word_count;
+    }
+    if (offset != checksum_offset) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(lock_);
+    entries_ = std::move(entries);
+    size_ = (checksum_offset - header_size) * sizeof(uint32_t);
+    dirty_ = false;
+    return true;
+}
+
+bool InstrumentedShaderCache::Save() {
+    std::vector<uint32_t> words;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (!dirty_) {
+            return true;
+        }
+        const Key tools_key = ToolsKey();
+        words.push_back(kFileMagic);
+        words.push_back(kFileVersion);
+        words.insert(words.end(), tools_key.begin(), tools_key.end());
+        words.push_back(static_cast<uint32_t>(entries_.size()));
+        for (const auto &entry : entries_) {
+            words.insert(words.end(), entry.first.begin(), entry.first.end());
+            words.push_back(entry.second.shader_id_offset);
+            words.push_back(static_cast<uint32_t>(entry.second.code.size()));
+            words.insert(words.end(), entry.second.code.begin(), entry.second.code.end());
+        }
+        dirty_ = false;
+    }
+    words.push_back(XXH32(words.data(), words.size() * sizeof(uint32_t), 0));
+
+    // Write next to the file and swap it in, so an application that is killed (or another process reading the cache) never sees a
+    // partially written file. Processes saving at the same time each write their own file, the last rename wins.
+#if defined(_WIN32)
+    const uint32_t process_id = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    const uint32_t process_id = static_cast<uint32_t>(getpid());
+#endif
+    const std::string temp_path = path_ + ".tmp." + std::to_string(process_id) + "." + std::to_string(save_count_++);
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(words.data()), words.size() * sizeof(uint32_t));
+        if (!file.flush()) {
+            file.close();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+#if defined(_WIN32)
+    const bool renamed = MoveFileExA(temp_path.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    // rename replaces the destination atomically
+    const bool renamed = std::rename(temp_path.c_str(), path_.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::remove(temp_path.c_str());
+    }
+    return renamed;
+}
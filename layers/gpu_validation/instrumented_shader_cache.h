@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core_checks/cc_shader.h"
+
+// Persistent cache of instrumented SPIR-V, so the spirv-opt instrumentation run by GPU-AV and Debug Printf is done once per shader
+// and set of instrumentation options, across runs of the application.
+//
+// The instrumentation passes write the shader id of the module into the code. Shaders added to the cache are instrumented with
+// kShaderIdPlaceholder as their id, and the placeholder constant is patched with the real id each time a binary is handed out.
+class InstrumentedShaderCache {
+  public:
+    using Key = ValidationCache::Key;
+    static constexpr uint32_t kShaderIdPlaceholder = 0x7E1D5EEDu;
+
+    explicit InstrumentedShaderCache(std::string path) : path_(std::move(path)) {}
+
+    // Reads the cache file, the cache is left empty if it is missing, corrupt, larger than kMaxFileSize, or written by another
+    // version of spirv-opt
+    bool Load();
+    // Writes the cache file, if anything was added since it was loaded. The file is written under a name unique to this process
+    // and renamed over the cache file, so that other processes only ever see a complete file.
+    bool Save();
+
+    // options must hold every other input of the instrumentation (passes, their parameters, target environment...)
+    static Key MakeKey(vvl::span<const uint32_t> code, const std::vector<uint32_t> &options);
+    // Code that happens to contain the placeholder value could not be patched safely, so must not be cached
+    static bool CanCache(vvl::span<const uint32_t> code);
+
+    // Returns the instrumented code for key, with shader_id as its shader id
+    bool Find(const Key &key, uint32_t shader_id, std::vector<uint32_t> &instrumented) const;
+    // Adds instrumented, made with kShaderIdPlaceholder as the shader id, then sets shader_id in it. Returns false and leaves
+    // instrumented untouched if the placeholder is found anywhere but in a single shader id constant. Once the cache holds
+    // kMaxFileSize bytes, new entries are not stored, but shader_id is still set in instrumented.
+    bool Add(const Key &key, std::vector<uint32_t> &instrumented, uint32_t shader_id);
+
+  private:
+    // Layout of the file: header, entries, then the XXH32 of everything before it
+    static constexpr uint32_t kFileMagic = 0x494C5656;  // "VVLI"
+    static constexpr uint32_t kFileVersion = 1;
+    static constexpr size_t kMaxFileSize = 64 * 1024 * 1024;
+
+    struct Entry {
+        std::vector<uint32_t> code;
+        uint32_t shader_id_offset;  // index of the word holding the shader id in code, 0 if the code has no shader id
+    };
+
+    static Key ToolsKey();
+
+    const std::string path_;
+    mutable std::mutex lock_;
+    vvl::unordered_map<Key, Entry, ValidationCache::KeyHash> entries_;
+    size_t size_ = 0;  // bytes of the entries, header and checksum excluded
+    bool dirty_ = false;
+    // Distinguishes the temporary files of caches of the same process, which can be saved concurrently from different devices
+    static std::atomic<uint32_t> save_count_;
+};
@@ -170,6 +170,7 @@ void CMD_BUFFER_STATE::ResetCBState() {
     startedQueries.clear();
     image_layout_map.clear();
     aliased_image_layout_map.clear();
+    validated_layout_generations.clear();
     descriptorset_cache.clear();
     current_vertex_buffer_binding_info.vertex_buffer_bindings.clear();
     vertex_buffer_used = false;
@@ -325,6 +325,10 @@ class CMD_BUFFER_STATE : public REFCOUNTED_NODE {
     vvl::unordered_set<QueryObject> updatedQueries;
     CommandBufferImageLayoutMap image_layout_map;
     CommandBufferAliasedLayoutMap aliased_image_layout_map;  // storage for potentially aliased images
+    // Generation of the global layout map of each image when it last matched the initial layouts of image_layout_map, which
+    // lets CoreChecks::ValidateCmdBufImageLayouts skip the images whose layouts did not change since
+    mutable vvl::unordered_map<const IMAGE_STATE *, uint64_t> validated_layout_generations;
+    mutable std::mutex validated_layout_generations_lock;
 
     CBVertexBufferBindingInfo current_vertex_buffer_binding_info;
     bool vertex_buffer_used;  // Track for perf warning to make sure any bound vtx buffer used
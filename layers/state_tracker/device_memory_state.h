@@ -152,8 +152,10 @@ class BindableSparseMemoryTracker : public BindableMemoryTracker {
         unsigned count = 0u;
         {
             auto guard = ReadLockGuard{binding_lock_};
-            for (const auto &range_state : binding_map_) {
-                count += (range_state.second.memory_state && range_state.second.memory_state->mem() == memory);
+            for (const auto &bound : bound_memory_) {
+                if (bound.second.memory_state->mem() == memory) {
+                    count += static_cast<unsigned>(bound.second.range_count);
+                }
             }
         }
 
@@ -163,18 +165,12 @@ class BindableSparseMemoryTracker : public BindableMemoryTracker {
 
     bool HasFullRangeBound() const {
         if (!IS_RESIDENT) {
-            VkDeviceSize current_offset = 0u;
-            {
-                auto guard = ReadLockGuard{binding_lock_};
-                for (const auto &range : binding_map_) {
-                    if (current_offset != range.first.begin || !range.second.memory_state || range.second.memory_state->Invalid()) {
-                        return false;
-                    }
-                    current_offset = range.first.end;
-                }
+            auto guard = ReadLockGuard{binding_lock_};
+            // The ranges of binding_map_ don't overlap, so they only add up to the resource size if they cover all of it
+            if (bound_size_ != resource_size_) return false;
+            for (const auto &bound : bound_memory_) {
+                if (bound.second.memory_state->Invalid()) return false;
             }
-
-            if (current_offset != resource_size_) return false;
         }
 
         return true;
@@ -182,19 +178,35 @@ class BindableSparseMemoryTracker : public BindableMemoryTracker {
 
     void BindMemory(BASE_NODE *parent, std::shared_ptr<DEVICE_MEMORY_STATE> &mem_state, VkDeviceSize memory_offset,
                     VkDeviceSize resource_offset, VkDeviceSize size) {
+        const sparse_container::range<VkDeviceSize> range{resource_offset, resource_offset + size};
+        if (range.empty()) return;
         MEM_BINDING memory_data{mem_state, memory_offset, resource_offset};
-        BindingMap::value_type item{{resource_offset, resource_offset + size}, memory_data};
 
         auto guard = WriteLockGuard{binding_lock_};
 
-        // Since we don't know which ranges will be removed, we need to unbind everything and rebind later
-        for (auto &value_pair : binding_map_) {
-            if (value_pair.second.memory_state) value_pair.second.memory_state->RemoveParent(parent);
+        // Only the ranges intersecting the new one change: they are removed, except for the parts of the first and last ones that
+        // are outside of it
+        std::vector<BindingMap::value_type> replaced;
+        const auto range_bounds = binding_map_.bounds(range);
+        for (auto it = range_bounds.begin; it != range_bounds.end; ++it) {
+            replaced.emplace_back(*it);
         }
-        binding_map_.overwrite_range(item);
-
-        for (auto &value_pair : binding_map_) {
-            if (value_pair.second.memory_state) value_pair.second.memory_state->AddParent(parent);
+        binding_map_.overwrite_range(BindingMap::value_type{range, memory_data});
+
+        // Add before removing, so that a memory object still bound elsewhere in the resource keeps its parent
+        AddBoundRange(parent, mem_state, range);
+        if (!replaced.empty()) {
+            const auto &front = replaced.front();
+            if (front.first.begin < range.begin) {
+                AddBoundRange(parent, front.second.memory_state, {front.first.begin, range.begin});
+            }
+            const auto &back = replaced.back();
+            if (back.first.end > range.end) {
+                AddBoundRange(parent, back.second.memory_state, {range.end, back.first.end});
+            }
+        }
+        for (const auto &entry : replaced) {
+            RemoveBoundRange(parent, entry.second.memory_state, entry.first);
         }
     }
 
@@ -223,8 +235,8 @@ class BindableSparseMemoryTracker : public BindableMemoryTracker {
 
         {
             auto guard = ReadLockGuard{binding_lock_};
-            for (auto &binding : binding_map_) {
-                if (binding.second.memory_state) dev_mem_states.emplace(binding.second.memory_state);
+            for (const auto &bound : bound_memory_) {
+                dev_mem_states.emplace(bound.second.memory_state);
             }
         }
 
@@ -234,7 +246,46 @@ class BindableSparseMemoryTracker : public BindableMemoryTracker {
   private:
     // This range map uses the range in resource space to know the size of the bound memory
     using BindingMap = sparse_container::range_map<VkDeviceSize, MEM_BINDING>;
+
+    // Number of ranges of binding_map_ bound to a memory object. The resource is a parent of the memory object while it is not 0.
+    struct BoundMemory {
+        std::shared_ptr<DEVICE_MEMORY_STATE> memory_state;
+        size_t range_count = 0;
+    };
+
+    VkDeviceSize SizeInResource(const sparse_container::range<VkDeviceSize> &range) const {
+        const VkDeviceSize end = std::min(range.end, resource_size_);
+        return range.begin < end ? end - range.begin : 0;
+    }
+
+    // Must be called with binding_lock_ held for writing
+    void AddBoundRange(BASE_NODE *parent, const std::shared_ptr<DEVICE_MEMORY_STATE> &mem_state,
+                       const sparse_container::range<VkDeviceSize> &range) {
+        if (!mem_state) return;
+        bound_size_ += SizeInResource(range);
+        auto &bound = bound_memory_[mem_state.get()];
+        if (bound.range_count++ == 0) {
+            bound.memory_state = mem_state;
+            mem_state->AddParent(parent);
+        }
+    }
+
+    // Must be called with binding_lock_ held for writing
+    void RemoveBoundRange(BASE_NODE *parent, const std::shared_ptr<DEVICE_MEMORY_STATE> &mem_state,
+                          const sparse_container::range<VkDeviceSize> &range) {
+        if (!mem_state) return;
+        bound_size_ -= SizeInResource(range);
+        auto bound_it = bound_memory_.find(mem_state.get());
+        assert(bound_it != bound_memory_.end());
+        if (--bound_it->second.range_count == 0) {
+            mem_state->RemoveParent(parent);
+            bound_memory_.erase(bound_it);
+        }
+    }
+
     BindingMap binding_map_;
+    vvl::unordered_map<const DEVICE_MEMORY_STATE *, BoundMemory> bound_memory_;
+    VkDeviceSize bound_size_ = 0;  // size of the parts of the resource that are bound to memory
     VkDeviceSize resource_size_;
     mutable std::shared_mutex binding_lock_;
 };
@@ -430,14 +481,33 @@ class MEMORY_TRACKED_RESOURCE_STATE : public BaseClass {
         auto ranges = GetBoundMemoryRange(memory_region);
         auto other_ranges = other_resource->GetBoundMemoryRange(other_memory_region);
 
-        for (const auto &value_pair : ranges) {
+        auto begins_first = [](const sparse_container::range<VkDeviceSize> &a, const sparse_container::range<VkDeviceSize> &b) {
+            return a.begin < b.begin;
+        };
+        for (auto &value_pair : ranges) {
             // Check if we have memory from same VkDeviceMemory bound
             auto it = other_ranges.find(value_pair.first);
             if (it != other_ranges.end()) {
-                // Check if any of the bound memory ranges overlap
-                for (const auto &memory_range : value_pair.second) {
-                    for (const auto &other_memory_range : it->second) {
-                        if (other_memory_range.intersects(memory_range)) return true;
+                // Check if any of the bound memory ranges overlap. Sparse resources can have a range per page, so rather than
+                // comparing every pair, sort both lists and walk them together: the range that ends first can't intersect any of
+                // the ranges left in the other list. Empty ranges don't overlap anything.
+                auto &memory_ranges = value_pair.second;
+                auto &other_memory_ranges = it->second;
+                std::sort(memory_ranges.begin(), memory_ranges.end(), begins_first);
+                std::sort(other_memory_ranges.begin(), other_memory_ranges.end(), begins_first);
+                size_t i = 0;
+                size_t j = 0;
+                while (i < memory_ranges.size() && j < other_memory_ranges.size()) {
+                    if (memory_ranges[i].empty()) {
+                        ++i;
+                    } else if (other_memory_ranges[j].empty()) {
+                        ++j;
+                    } else if (other_memory_ranges[j].intersects(memory_ranges[i])) {
+                        return true;
+                    } else if (memory_ranges[i].end <= other_memory_ranges[j].end) {
+                        ++i;
+                    } else {
+                        ++j;
                     }
                 }
             }
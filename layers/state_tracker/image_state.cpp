@@ -373,6 +373,7 @@ void IMAGE_STATE::SetInitialLayoutMap() {
         for (; range_gen->non_empty(); ++range_gen) {
             new_map->insert(new_map->end(), std::make_pair(*range_gen, createInfo.initialLayout));
         }
+        new_map->Consolidate();
         layout_range_map = std::move(new_map);
     }
 }
@@ -60,12 +60,48 @@ static inline VkImageSubresourceRange RangeFromLayers(const VkImageSubresourceLa
 
 class GlobalImageLayoutRangeMap : public subresource_adapter::BothRangeMap<VkImageLayout, 16> {
   public:
-    GlobalImageLayoutRangeMap(index_type index) : BothRangeMap<VkImageLayout, 16>(index) {}
+    GlobalImageLayoutRangeMap(index_type index)
+        : BothRangeMap<VkImageLayout, 16>(index), limit_(index), generation_(NextGeneration()) {}
     ReadLockGuard ReadLock() const { return ReadLockGuard(lock_); }
     WriteLockGuard WriteLock() { return WriteLockGuard(lock_); }
 
+    // Merges adjacent ranges in the same layout, so that an image moved back into a single layout piece by piece (one mip level
+    // or array layer at a time) is a single entry again. Small maps hold at most 16 entries and are left as they are. Must be
+    // called with the map locked for writing.
+    void Consolidate() {
+        if (BigMode()) {
+            sparse_container::consolidate(GetBigMap());
+        }
+    }
+    // Returns true, and the layout in layout, if every subresource of the image is in the same layout. Must be called with the
+    // map locked.
+    bool UniformLayout(VkImageLayout &layout) const {
+        if (size() != 1) {
+            return false;
+        }
+        const auto &entry = *begin();
+        if (entry.first.begin != 0 || entry.first.end != limit_) {
+            return false;
+        }
+        layout = entry.second;
+        return true;
+    }
+
+    // Changes each time a layout in the map changes. Generations are never reused, even by other maps, so they also tell apart
+    // the maps of different images. Must be read with the map locked.
+    uint64_t Generation() const { return generation_; }
+    // Must be called with the map locked for writing, after changing layouts in it
+    void LayoutsChanged() { generation_ = NextGeneration(); }
+
   private:
+    static uint64_t NextGeneration() {
+        static std::atomic<uint64_t> next_generation{1};
+        return next_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const index_type limit_;
     mutable std::shared_mutex lock_;
+    uint64_t generation_;
 };
 
 // State for VkImage objects.
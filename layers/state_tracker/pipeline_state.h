@@ -341,11 +341,11 @@ class PIPELINE_STATE : public BASE_NODE {
         if (fragment_shader_state && fragment_shader_state->ms_state &&
             (fragment_shader_state->ms_state->rasterizationSamples >= VK_SAMPLE_COUNT_1_BIT) &&
             (fragment_shader_state->ms_state->rasterizationSamples < VK_SAMPLE_COUNT_FLAG_BITS_MAX_ENUM)) {
-            return fragment_shader_state->ms_state.get();
+            return fragment_shader_state->ms_state;
         } else if (fragment_output_state && fragment_output_state->ms_state &&
                    (fragment_output_state->ms_state->rasterizationSamples >= VK_SAMPLE_COUNT_1_BIT) &&
                    (fragment_output_state->ms_state->rasterizationSamples < VK_SAMPLE_COUNT_FLAG_BITS_MAX_ENUM)) {
-            return fragment_output_state->ms_state.get();
+            return fragment_output_state->ms_state;
         }
         return nullptr;
     }
@@ -375,7 +375,7 @@ class PIPELINE_STATE : public BASE_NODE {
 
     const safe_VkPipelineColorBlendStateCreateInfo *ColorBlendState() const {
         if (fragment_output_state) {
-            return fragment_output_state->color_blend_state.get();
+            return fragment_output_state->color_blend_state;
         }
         return nullptr;
     }
@@ -414,8 +414,8 @@ class PIPELINE_STATE : public BASE_NODE {
     }
 
     const FragmentOutputState::AttachmentVector &Attachments() const {
-        if (fragment_output_state) {
-            return fragment_output_state->attachments;
+        if (fragment_output_state && fragment_output_state->attachments) {
+            return *fragment_output_state->attachments;
         }
         static FragmentOutputState::AttachmentVector empty_vec = {};
         return empty_vec;
@@ -423,7 +423,7 @@ class PIPELINE_STATE : public BASE_NODE {
 
     const safe_VkPipelineDepthStencilStateCreateInfo *DepthStencilState() const {
         if (fragment_shader_state) {
-            return fragment_shader_state->ds_state.get();
+            return fragment_shader_state->ds_state;
         }
         return nullptr;
     }
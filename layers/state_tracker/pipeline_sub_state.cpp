@@ -23,39 +23,64 @@ VkPipelineLayoutCreateFlags PipelineSubState::PipelineLayoutCreateFlags() const
     return (layout_state) ? layout_state->CreateFlags() : static_cast<VkPipelineLayoutCreateFlags>(0);
 }
 
-VertexInputState::VertexInputState(const PIPELINE_STATE &p, const safe_VkGraphicsPipelineCreateInfo &create_info)
-    : PipelineSubState(p), input_state(create_info.pVertexInputState), input_assembly_state(create_info.pInputAssemblyState) {
-    if (create_info.pVertexInputState) {
-        const auto *vici = create_info.pVertexInputState;
-        if (vici->vertexBindingDescriptionCount) {
-            const auto count = vici->vertexBindingDescriptionCount;
-            binding_descriptions.reserve(count);
-            binding_to_index_map.reserve(count);
-
-            for (uint32_t i = 0; i < count; i++) {
-                binding_descriptions.emplace_back(vici->pVertexBindingDescriptions[i]);
-                binding_to_index_map[binding_descriptions.back().binding] = i;
-            }
+VertexInputDescriptions::VertexInputDescriptions(const safe_VkPipelineVertexInputStateCreateInfo &vici) {
+    if (vici.vertexBindingDescriptionCount) {
+        const auto count = vici.vertexBindingDescriptionCount;
+        binding_descriptions.reserve(count);
+        binding_to_index_map.reserve(count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            binding_descriptions.emplace_back(vici.pVertexBindingDescriptions[i]);
+            binding_to_index_map[binding_descriptions.back().binding] = i;
         }
+    }
 
-        if (vici->vertexAttributeDescriptionCount) {
-            vertex_attribute_descriptions.reserve(vici->vertexAttributeDescriptionCount);
-            std::copy(vici->pVertexAttributeDescriptions,
-                      vici->pVertexAttributeDescriptions + vici->vertexAttributeDescriptionCount,
-                      std::back_inserter(vertex_attribute_descriptions));
-        }
+    if (vici.vertexAttributeDescriptionCount) {
+        vertex_attribute_descriptions.reserve(vici.vertexAttributeDescriptionCount);
+        std::copy(vici.pVertexAttributeDescriptions, vici.pVertexAttributeDescriptions + vici.vertexAttributeDescriptionCount,
+                  std::back_inserter(vertex_attribute_descriptions));
+    }
 
-        vertex_attribute_alignments.reserve(vertex_attribute_descriptions.size());
-        for (const auto &attr : vertex_attribute_descriptions) {
-            VkDeviceSize vtx_attrib_req_alignment = FormatElementSize(attr.format);
-            if (FormatElementIsTexel(attr.format)) {
-                vtx_attrib_req_alignment = SafeDivision(vtx_attrib_req_alignment, FormatComponentCount(attr.format));
-            }
-            vertex_attribute_alignments.push_back(vtx_attrib_req_alignment);
+    vertex_attribute_alignments.reserve(vertex_attribute_descriptions.size());
+    for (const auto &attr : vertex_attribute_descriptions) {
+        VkDeviceSize vtx_attrib_req_alignment = FormatElementSize(attr.format);
+        if (FormatElementIsTexel(attr.format)) {
+            vtx_attrib_req_alignment = SafeDivision(vtx_attrib_req_alignment, FormatComponentCount(attr.format));
         }
+        vertex_attribute_alignments.push_back(vtx_attrib_req_alignment);
     }
 }
 
+size_t VertexInputDescriptions::hash() const {
+    hash_util::HashCombiner hc;
+    hc.Combine(binding_descriptions);
+    hc.Combine(vertex_attribute_descriptions);
+    return hc.Value();
+}
+
+// Most applications only use a handful of vertex layouts across all of their pipelines
+static VertexInputDescriptionsDict vertex_input_descriptions_dict;
+
+// static
+std::shared_ptr<const VertexInputDescriptions> VertexInputState::GetDescriptions(
+    const safe_VkGraphicsPipelineCreateInfo &create_info) {
+    if (!create_info.pVertexInputState) {
+        static const auto empty = std::make_shared<const VertexInputDescriptions>();
+        return empty;
+    }
+    return vertex_input_descriptions_dict.look_up(VertexInputDescriptions(*create_info.pVertexInputState));
+}
+
+VertexInputState::VertexInputState(const PIPELINE_STATE &p, const safe_VkGraphicsPipelineCreateInfo &create_info)
+    : PipelineSubState(p),
+      input_state(create_info.pVertexInputState),
+      input_assembly_state(create_info.pInputAssemblyState),
+      descriptions_(GetDescriptions(create_info)),
+      binding_descriptions(descriptions_->binding_descriptions),
+      binding_to_index_map(descriptions_->binding_to_index_map),
+      vertex_attribute_descriptions(descriptions_->vertex_attribute_descriptions),
+      vertex_attribute_alignments(descriptions_->vertex_attribute_alignments) {}
+
 PreRasterState::PreRasterState(const PIPELINE_STATE &p, const ValidationStateTracker &dev_data,
                                const safe_VkGraphicsPipelineCreateInfo &create_info, std::shared_ptr<const RENDER_PASS_STATE> rp)
     : PipelineSubState(p), rp_state(rp), subpass(create_info.subpass) {
@@ -128,41 +153,6 @@ PreRasterState::PreRasterState(const PIPELINE_STATE &p, const ValidationStateTra
     }
 }
 
-std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> ToSafeColorBlendState(
-    const safe_VkPipelineColorBlendStateCreateInfo &cbs) {
-    // This is needlessly copied here. Might better to make this a plain pointer, with an optional "backing unique_ptr"
-    return std::make_unique<const safe_VkPipelineColorBlendStateCreateInfo>(cbs);
-}
-std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> ToSafeColorBlendState(
-    const VkPipelineColorBlendStateCreateInfo &cbs) {
-    return std::make_unique<const safe_VkPipelineColorBlendStateCreateInfo>(&cbs);
-}
-std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ToSafeMultisampleState(
-    const safe_VkPipelineMultisampleStateCreateInfo &cbs) {
-    // This is needlessly copied here. Might better to make this a plain pointer, with an optional "backing unique_ptr"
-    return std::make_unique<const safe_VkPipelineMultisampleStateCreateInfo>(cbs);
-}
-std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ToSafeMultisampleState(
-    const VkPipelineMultisampleStateCreateInfo &cbs) {
-    return std::make_unique<const safe_VkPipelineMultisampleStateCreateInfo>(&cbs);
-}
-std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ToSafeDepthStencilState(
-    const safe_VkPipelineDepthStencilStateCreateInfo &cbs) {
-    // This is needlessly copied here. Might better to make this a plain pointer, with an optional "backing unique_ptr"
-    return std::make_unique<const safe_VkPipelineDepthStencilStateCreateInfo>(cbs);
-}
-std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ToSafeDepthStencilState(
-    const VkPipelineDepthStencilStateCreateInfo &cbs) {
-    return std::make_unique<const safe_VkPipelineDepthStencilStateCreateInfo>(&cbs);
-}
-std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> ToShaderStageCI(const safe_VkPipelineShaderStageCreateInfo &cbs) {
-    // This is needlessly copied here. Might better to make this a plain pointer, with an optional "backing unique_ptr"
-    return std::make_unique<const safe_VkPipelineShaderStageCreateInfo>(cbs);
-}
-std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> ToShaderStageCI(const VkPipelineShaderStageCreateInfo &cbs) {
-    return std::make_unique<const safe_VkPipelineShaderStageCreateInfo>(&cbs);
-}
-
 template <typename CreateInfo>
 void SetFragmentShaderInfoPrivate(FragmentShaderState &fs_state, const ValidationStateTracker &state_data,
                                   const CreateInfo &create_info) {
@@ -190,7 +180,7 @@ void SetFragmentShaderInfoPrivate(FragmentShaderState &fs_state, const Validatio
 
             if (module_state) {
                 fs_state.fragment_shader = std::move(module_state);
-                fs_state.fragment_shader_ci = ToShaderStageCI(create_info.pStages[i]);
+                fs_state.fragment_shader_ci = GetSubStateCreateInfo(create_info.pStages[i], fs_state.fragment_shader_ci_storage);
             }
         }
     }
@@ -215,6 +205,13 @@ FragmentShaderState::FragmentShaderState(const PIPELINE_STATE &p, const Validati
 FragmentOutputState::FragmentOutputState(const PIPELINE_STATE &p, std::shared_ptr<const RENDER_PASS_STATE> rp, uint32_t sp)
     : PipelineSubState(p), rp_state(rp), subpass(sp) {}
 
+static FragmentOutputState::AttachmentVectorDict attachment_vector_dict;
+
+// static
+std::shared_ptr<const FragmentOutputState::AttachmentVector> FragmentOutputState::GetAttachments(AttachmentVector &&attachments) {
+    return attachment_vector_dict.look_up(std::move(attachments));
+}
+
 // static
 bool FragmentOutputState::IsBlendConstantsEnabled(const AttachmentVector &attachments) {
     bool result = false;
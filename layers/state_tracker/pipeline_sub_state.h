@@ -19,6 +19,8 @@
 
 #include "state_tracker/pipeline_layout_state.h"
 #include "generated/vk_safe_struct.h"
+#include "utils/hash_util.h"
+#include "utils/hash_vk_types.h"
 
 // Graphics pipeline sub-state as defined by VK_KHR_graphics_pipeline_library
 //
@@ -42,12 +44,9 @@ struct PipelineSubState {
     VkPipelineLayoutCreateFlags PipelineLayoutCreateFlags() const;
 };
 
-struct VertexInputState : public PipelineSubState {
-    VertexInputState(const PIPELINE_STATE &p, const safe_VkGraphicsPipelineCreateInfo &create_info);
-
-    safe_VkPipelineVertexInputStateCreateInfo *input_state = nullptr;
-    safe_VkPipelineInputAssemblyStateCreateInfo *input_assembly_state = nullptr;
-
+// Vertex input descriptions derived from VkPipelineVertexInputStateCreateInfo. They are immutable, and pipelines with the same
+// descriptions share one canonical copy, see VertexInputState::GetDescriptions.
+struct VertexInputDescriptions {
     using VertexBindingVector = std::vector<VkVertexInputBindingDescription>;
     VertexBindingVector binding_descriptions;
 
@@ -60,6 +59,42 @@ struct VertexInputState : public PipelineSubState {
     using VertexAttrAlignmentVector = std::vector<VkDeviceSize>;
     VertexAttrAlignmentVector vertex_attribute_alignments;
 
+    VertexInputDescriptions() = default;
+    explicit VertexInputDescriptions(const safe_VkPipelineVertexInputStateCreateInfo &vici);
+
+    // The index map and alignments are derived from the descriptions, so they take no part in the comparison
+    size_t hash() const;
+    bool operator==(const VertexInputDescriptions &rhs) const {
+        return (binding_descriptions == rhs.binding_descriptions) &&
+               (vertex_attribute_descriptions == rhs.vertex_attribute_descriptions);
+    }
+};
+using VertexInputDescriptionsDict =
+    hash_util::Dictionary<VertexInputDescriptions, hash_util::HasHashMember<VertexInputDescriptions>>;
+
+struct VertexInputState : public PipelineSubState {
+    VertexInputState(const PIPELINE_STATE &p, const safe_VkGraphicsPipelineCreateInfo &create_info);
+
+    safe_VkPipelineVertexInputStateCreateInfo *input_state = nullptr;
+    safe_VkPipelineInputAssemblyStateCreateInfo *input_assembly_state = nullptr;
+
+  private:
+    static std::shared_ptr<const VertexInputDescriptions> GetDescriptions(const safe_VkGraphicsPipelineCreateInfo &create_info);
+    const std::shared_ptr<const VertexInputDescriptions> descriptions_;
+
+  public:
+    using VertexBindingVector = VertexInputDescriptions::VertexBindingVector;
+    const VertexBindingVector &binding_descriptions;
+
+    using VertexBindingIndexMap = VertexInputDescriptions::VertexBindingIndexMap;
+    const VertexBindingIndexMap &binding_to_index_map;
+
+    using VertexAttrVector = VertexInputDescriptions::VertexAttrVector;
+    const VertexAttrVector &vertex_attribute_descriptions;
+
+    using VertexAttrAlignmentVector = VertexInputDescriptions::VertexAttrAlignmentVector;
+    const VertexAttrAlignmentVector &vertex_attribute_alignments;
+
     std::shared_ptr<VertexInputState> FromCreateInfo(const ValidationStateTracker &state,
                                                      const safe_VkGraphicsPipelineCreateInfo &create_info);
 };
@@ -90,20 +125,17 @@ struct PreRasterState : public PipelineSubState {
                                                *task_shader_ci = nullptr, *mesh_shader_ci = nullptr;
 };
 
-std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> ToSafeColorBlendState(
-    const safe_VkPipelineColorBlendStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> ToSafeColorBlendState(
-    const VkPipelineColorBlendStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ToSafeMultisampleState(
-    const safe_VkPipelineMultisampleStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ToSafeMultisampleState(
-    const VkPipelineMultisampleStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ToSafeDepthStencilState(
-    const safe_VkPipelineDepthStencilStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ToSafeDepthStencilState(
-    const VkPipelineDepthStencilStateCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> ToShaderStageCI(const safe_VkPipelineShaderStageCreateInfo &cbs);
-std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> ToShaderStageCI(const VkPipelineShaderStageCreateInfo &cbs);
+// Sub-states of a pipeline point into the safe create info of their pipeline. Graphics libraries are built from the application's
+// create info instead, as the safe copy strips out the states a library may define, so they keep a copy of their own in storage.
+template <typename SafeType>
+const SafeType *GetSubStateCreateInfo(const SafeType &create_info, std::unique_ptr<const SafeType> &) {
+    return &create_info;
+}
+template <typename SafeType, typename CreateInfo>
+const SafeType *GetSubStateCreateInfo(const CreateInfo &create_info, std::unique_ptr<const SafeType> &storage) {
+    storage = std::make_unique<const SafeType>(&create_info);
+    return storage.get();
+}
 
 struct FragmentShaderState : public PipelineSubState {
     FragmentShaderState(const PIPELINE_STATE &p, const ValidationStateTracker &dev_data,
@@ -114,10 +146,10 @@ struct FragmentShaderState : public PipelineSubState {
                         std::shared_ptr<const RENDER_PASS_STATE> rp)
         : FragmentShaderState(p, dev_data, rp, create_info.subpass, create_info.layout) {
         if (create_info.pMultisampleState) {
-            ms_state = ToSafeMultisampleState(*create_info.pMultisampleState);
+            ms_state = GetSubStateCreateInfo(*create_info.pMultisampleState, ms_state_storage);
         }
         if (create_info.pDepthStencilState) {
-            ds_state = ToSafeDepthStencilState(*create_info.pDepthStencilState);
+            ds_state = GetSubStateCreateInfo(*create_info.pDepthStencilState, ds_state_storage);
         }
         FragmentShaderState::SetFragmentShaderInfo(*this, dev_data, create_info);
     }
@@ -128,11 +160,16 @@ struct FragmentShaderState : public PipelineSubState {
     uint32_t subpass = 0;
 
     std::shared_ptr<const PIPELINE_LAYOUT_STATE> pipeline_layout;
-    std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ms_state;
-    std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ds_state;
+    const safe_VkPipelineMultisampleStateCreateInfo *ms_state = nullptr;
+    const safe_VkPipelineDepthStencilStateCreateInfo *ds_state = nullptr;
 
     std::shared_ptr<const SHADER_MODULE_STATE> fragment_shader;
-    std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> fragment_shader_ci;
+    const safe_VkPipelineShaderStageCreateInfo *fragment_shader_ci = nullptr;
+
+    // Only used by graphics libraries, see GetSubStateCreateInfo
+    std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ms_state_storage;
+    std::unique_ptr<const safe_VkPipelineDepthStencilStateCreateInfo> ds_state_storage;
+    std::unique_ptr<const safe_VkPipelineShaderStageCreateInfo> fragment_shader_ci_storage;
 
   private:
     static void SetFragmentShaderInfo(FragmentShaderState &fs_state, const ValidationStateTracker &state_data,
@@ -156,6 +193,7 @@ static bool IsSampleLocationEnabled(const CreateInfo &create_info) {
 
 struct FragmentOutputState : public PipelineSubState {
     using AttachmentVector = std::vector<VkPipelineColorBlendAttachmentState>;
+    using AttachmentVectorDict = hash_util::Dictionary<AttachmentVector, hash_util::IsOrderedContainer<AttachmentVector>>;
 
     FragmentOutputState(const PIPELINE_STATE &p, std::shared_ptr<const RENDER_PASS_STATE> rp, uint32_t sp);
     // For a graphics library, a "non-safe" create info must be passed in in order for pColorBlendState and pMultisampleState to not
@@ -166,20 +204,17 @@ struct FragmentOutputState : public PipelineSubState {
         : FragmentOutputState(p, rp, create_info.subpass) {
         if (create_info.pColorBlendState) {
             const auto &cbci = *create_info.pColorBlendState;
-            color_blend_state = ToSafeColorBlendState(cbci);
+            color_blend_state = GetSubStateCreateInfo(cbci, color_blend_state_storage);
             // In case of being dynamic state
             if (cbci.pAttachments) {
-                dual_source_blending = GetDualSourceBlending(color_blend_state.get());
-                if (cbci.attachmentCount) {
-                    attachments.reserve(cbci.attachmentCount);
-                    std::copy(cbci.pAttachments, cbci.pAttachments + cbci.attachmentCount, std::back_inserter(attachments));
-                }
-                blend_constants_enabled = IsBlendConstantsEnabled(attachments);
+                dual_source_blending = GetDualSourceBlending(color_blend_state);
+                attachments = GetAttachments(AttachmentVector(cbci.pAttachments, cbci.pAttachments + cbci.attachmentCount));
+                blend_constants_enabled = IsBlendConstantsEnabled(*attachments);
             }
         }
 
         if (create_info.pMultisampleState) {
-            ms_state = ToSafeMultisampleState(*create_info.pMultisampleState);
+            ms_state = GetSubStateCreateInfo(*create_info.pMultisampleState, ms_state_storage);
             sample_location_enabled = IsSampleLocationEnabled(create_info);
         }
 
@@ -189,14 +224,20 @@ struct FragmentOutputState : public PipelineSubState {
 
     static bool IsBlendConstantsEnabled(const AttachmentVector &attachments);
     static bool GetDualSourceBlending(const safe_VkPipelineColorBlendStateCreateInfo *color_blend_state);
+    // Returns the canonical copy of attachments, shared by every pipeline with the same blend attachment states
+    static std::shared_ptr<const AttachmentVector> GetAttachments(AttachmentVector &&attachments);
 
     std::shared_ptr<const RENDER_PASS_STATE> rp_state;
     uint32_t subpass = 0;
 
-    std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> color_blend_state;
-    std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ms_state;
+    const safe_VkPipelineColorBlendStateCreateInfo *color_blend_state = nullptr;
+    const safe_VkPipelineMultisampleStateCreateInfo *ms_state = nullptr;
+
+    // Only used by graphics libraries, see GetSubStateCreateInfo
+    std::unique_ptr<const safe_VkPipelineColorBlendStateCreateInfo> color_blend_state_storage;
+    std::unique_ptr<const safe_VkPipelineMultisampleStateCreateInfo> ms_state_storage;
 
-    AttachmentVector attachments;
+    std::shared_ptr<const AttachmentVector> attachments;
 
     bool blend_constants_enabled = false;  // Blend constants enabled for any attachments
     bool sample_location_enabled = false;
@@ -15,12 +15,15 @@
 
 #include "state_tracker/shader_module.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <string>
 
 #include "state_tracker/pipeline_state.h"
 #include "state_tracker/descriptor_sets.h"
 #include "generated/spirv_grammar_helper.h"
+#include "external/xxhash.h"
 
 void DecorationBase::Add(uint32_t decoration, uint32_t value) {
     switch (decoration) {
@@ -567,16 +570,17 @@ SHADER_MODULE_STATE::StaticData::StaticData(const SHADER_MODULE_STATE& module_st
         instructions.shrink_to_fit();
     }
 
-    // These have their own object class, but need entire module parsed first
-    std::vector<const Instruction*> entry_point_instructions;
-    std::vector<const Instruction*> type_struct_instructions;
+    // Every id is defined by an instruction of at least one word, so a Bound larger than the module is not trusted. Ids outside of
+    // it are invalid and have no definition.
+    const uint32_t id_bound = module_state.words_.size() > 3 ? module_state.words_[3] : 0;
+    definitions.resize(std::min(static_cast<size_t>(id_bound), module_state.words_.size()), nullptr);
 
     // Loop through once and build up the static data
     // Also process the entry points
     for (const Instruction& insn : instructions) {
         // Build definition list
         const uint32_t result_id = insn.ResultId();
-        if (result_id != 0) {
+        if (result_id != 0 && result_id < definitions.size()) {
             definitions[result_id] = &insn;
         }
 
@@ -639,7 +643,7 @@ SHADER_MODULE_STATE::StaticData::StaticData(const SHADER_MODULE_STATE& module_st
 
             // Entry points
             case spv::OpEntryPoint: {
-                entry_point_instructions.push_back(&insn);
+                entry_point_inst.push_back(&insn);
                 break;
             }
 
@@ -745,7 +749,7 @@ SHADER_MODULE_STATE::StaticData::StaticData(const SHADER_MODULE_STATE& module_st
                 break;
             }
             case spv::OpTypeStruct: {
-                type_struct_instructions.push_back(&insn);
+                type_struct_inst.push_back(&insn);
                 break;
             }
             case spv::OpReadClockKHR: {
@@ -781,19 +785,28 @@ SHADER_MODULE_STATE::StaticData::StaticData(const SHADER_MODULE_STATE& module_st
             builtin_workgroup_size_id = decoration_inst->Word(1);
         }
     }
+}
 
-    // Need to get struct first and EntryPoint's variables depend on it
-    for (const auto& insn : type_struct_instructions) {
-        auto new_struct = type_structs.emplace_back(std::make_shared<TypeStructInfo>(module_state, *insn));
-        type_struct_map[new_struct->id] = new_struct;
-    }
-
-    // Need to build the definitions table for FindDef before looking for which instructions each entry point uses
-    for (const auto& insn : entry_point_instructions) {
-        entry_points.emplace_back(std::make_shared<EntryPoint>(module_state, *insn));
-    }
+// The StaticData may be shared with other modules of identical code, any of them can build the lazy parts of it
+const std::vector<std::shared_ptr<EntryPoint>>& SHADER_MODULE_STATE::GetEntryPoints() const {
+    std::call_once(static_data_.entry_points_once, [this]() {
+        // EntryPoint's variables depend on the struct info, which GetTypeStructInfo() builds first if needed
+        for (const auto& insn : static_data_.entry_point_inst) {
+            static_data_.entry_points.emplace_back(std::make_shared<EntryPoint>(*this, *insn));
+        }
+        SetPushConstantUsedInShader(*this, static_data_.entry_points);
+    });
+    return static_data_.entry_points;
+}
 
-    SHADER_MODULE_STATE::SetPushConstantUsedInShader(module_state, entry_points);
+const vvl::unordered_map<uint32_t, std::shared_ptr<const TypeStructInfo>>& SHADER_MODULE_STATE::GetTypeStructMap() const {
+    std::call_once(static_data_.type_structs_once, [this]() {
+        for (const auto& insn : static_data_.type_struct_inst) {
+            auto new_struct = static_data_.type_structs.emplace_back(std::make_shared<TypeStructInfo>(*this, *insn));
+            static_data_.type_struct_map[new_struct->id] = new_struct;
+        }
+    });
+    return static_data_.type_struct_map;
 }
 
 void SHADER_MODULE_STATE::DescribeTypeInner(std::ostringstream& ss, uint32_t type, uint32_t indent) const {
@@ -873,7 +886,7 @@ std::string SHADER_MODULE_STATE::DescribeType(uint32_t type) const {
 }
 
 const StructInfo* SHADER_MODULE_STATE::FindEntrypointPushConstant(char const* name, VkShaderStageFlagBits stageBits) const {
-    for (const auto& entry_point : static_data_.entry_points) {
+    for (const auto& entry_point : GetEntryPoints()) {
         if (entry_point->name.compare(name) == 0 && entry_point->stage == stageBits) {
             return &(entry_point->push_constant_used_in_shader);
         }
@@ -882,7 +895,7 @@ const StructInfo* SHADER_MODULE_STATE::FindEntrypointPushConstant(char const* na
 }
 
 std::shared_ptr<const EntryPoint> SHADER_MODULE_STATE::FindEntrypoint(char const* name, VkShaderStageFlagBits stageBits) const {
-    for (const auto& entry_point : static_data_.entry_points) {
+    for (const auto& entry_point : GetEntryPoints()) {
         if (entry_point->name.compare(name) == 0 && entry_point->stage == stageBits) {
             return entry_point;
         }
@@ -2016,3 +2029,95 @@ uint32_t SHADER_MODULE_STATE::GetTexelComponentCount(const Instruction& insn) co
     }
     return texel_component_count;
 }
+
+SpirvModuleCache& SpirvModuleCache::Instance() {
+    static SpirvModuleCache cache;
+    return cache;
+}
+
+// Drops the entries of bucket that expired and returns the live one for code, if any
+std::shared_ptr<const SHADER_MODULE_STATE> SpirvModuleCache::FindModule(Bucket& bucket, vvl::span<const uint32_t> code) {
+    std::shared_ptr<const SHADER_MODULE_STATE> found;
+    for (auto it = bucket.begin(); it != bucket.end();) {
+        auto module_state = it->lock();
+        if (!module_state) {
+            it = bucket.erase(it);
+            entry_count_--;
+            continue;
+        }
+        if (!found && module_state->words_.size() == code.size() &&
+            std::equal(code.begin(), code.end(), module_state->words_.begin())) {
+            found = std::move(module_state);
+        }
+        ++it;
+    }
+    return found;
+}
+
+void SpirvModuleCache::SweepExpired() {
+    for (auto bucket = modules_.begin(); bucket != modules_.end();) {
+        auto& entries = bucket->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const auto& entry) { return entry.expired(); }),
+                      entries.end());
+        if (entries.empty()) {
+            bucket = modules_.erase(bucket);
+        } else {
+            ++bucket;
+        }
+    }
+    entry_count_ = 0;
+    for (const auto& bucket : modules_) {
+        entry_count_ += bucket.second.size();
+    }
+    swept_entry_count_ = entry_count_;
+}
+
+std::shared_ptr<const SHADER_MODULE_STATE> SpirvModuleCache::Get(vvl::span<const uint32_t> code) {
+    const uint32_t hash = XXH32(code.data(), code.size() * sizeof(uint32_t), 0);
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto bucket = modules_.find(hash);
+        if (bucket != modules_.end()) {
+            if (auto module_state = FindModule(bucket->second, code)) {
+                stats_.shared_modules++;
+                stats_.shared_bytes += code.size() * sizeof(uint32_t);
+                return module_state;
+            }
+            if (bucket->second.empty()) {
+                modules_.erase(bucket);
+            }
+        }
+    }
+
+    // Parse without holding the lock, if another thread parsed the same code in the meantime its parse is used instead.
+    // Not make_shared, which would keep the module alive in the allocation of its control block until the entry is swept.
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const SHADER_MODULE_STATE> parsed_module(new SHADER_MODULE_STATE(code));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    stats_.parse_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    auto& bucket = modules_[hash];
+    if (auto module_state = FindModule(bucket, code)) {
+        stats_.shared_modules++;
+        stats_.shared_bytes += code.size() * sizeof(uint32_t);
+        return module_state;
+    }
+    stats_.parsed_modules++;
+    bucket.emplace_back(parsed_module);
+    if (++entry_count_ > 2 * swept_entry_count_) {
+        SweepExpired();
+    }
+    return parsed_module;
+}
+
+SpirvModuleCache::Stats SpirvModuleCache::GetStats() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    Stats stats = stats_;
+    for (const auto& bucket : modules_) {
+        for (const auto& entry : bucket.second) {
+            stats.live_parsed_modules += entry.expired() ? 0 : 1;
+        }
+    }
+    return stats;
+}
@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -420,15 +423,14 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
     struct StaticData {
         StaticData() = default;
         StaticData(const SHADER_MODULE_STATE &module_state);
-        StaticData &operator=(StaticData &&) = default;
-        StaticData(StaticData &&) = default;
 
-        // List of all instructions in the order they appear in the binary
+        // List of all instructions in the order they appear in the binary, as views into SHADER_MODULE_STATE::words_
         std::vector<Instruction> instructions;
         // Instructions that can be referenced by Ids
-        // A mapping of <id> to the first word of its def. this is useful because walking type
+        // Indexed by <id>, nullptr for ids without a def. this is useful because walking type
         // trees, constant expressions, etc requires jumping all over the instruction stream.
-        vvl::unordered_map<uint32_t, const Instruction *> definitions;
+        // SPIR-V ids are below the Bound of the header, so this is dense.
+        std::vector<const Instruction *> definitions;
 
         vvl::unordered_map<uint32_t, DecorationSet> decorations;
         DecorationSet empty_decoration;  // all zero values, allows use to return a reference and not a copy each time
@@ -463,12 +465,24 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
         bool has_specialization_constants{false};
         bool has_invocation_repack_instruction{false};
 
+        std::vector<const Instruction *> entry_point_inst;
+        std::vector<const Instruction *> type_struct_inst;
+
+        // The EntryPoint and TypeStructInfo objects are only built the first time a check asks for them (see GetEntryPoints() and
+        // GetTypeStructInfo()), as they walk the whole module and most modules of large shader libraries are never looked at
+        mutable std::once_flag entry_points_once;
         // EntryPoint has pointer references inside it that need to be preserved
-        std::vector<std::shared_ptr<EntryPoint>> entry_points;
+        mutable std::vector<std::shared_ptr<EntryPoint>> entry_points;
 
-        std::vector<std::shared_ptr<TypeStructInfo>> type_structs;  // All OpTypeStruct objects
+        mutable std::once_flag type_structs_once;
+        mutable std::vector<std::shared_ptr<TypeStructInfo>> type_structs;  // All OpTypeStruct objects
         // <OpTypeStruct ID, info> - used for faster lookup as there can many structs
-        vvl::unordered_map<uint32_t, std::shared_ptr<const TypeStructInfo>> type_struct_map;
+        mutable vvl::unordered_map<uint32_t, std::shared_ptr<const TypeStructInfo>> type_struct_map;
+
+        // Hash of the module words for the validation cache (see ValidationCache::Key), computed the first time a specialized stage
+        // key is made from the module
+        mutable std::once_flag content_key_once;
+        mutable std::array<uint32_t, 4> content_key{};
 
         bool has_group_decoration{false};
 
@@ -490,32 +504,59 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
         vvl::unordered_map<uint32_t, uint32_t> image_texel_pointer_members;               // <result id, image>
     };
 
+  private:
+    // When set, words_ and static_data_ are those of this module, which was parsed from identical code (see SpirvModuleCache),
+    // and own_words_ and own_static_data_ are left empty
+    const std::shared_ptr<const SHADER_MODULE_STATE> shared_module_;
+    const std::vector<uint32_t> own_words_;
+
+  public:
     // This is the SPIR-V module data content
-    const std::vector<uint32_t> words_;
+    const std::vector<uint32_t> &words_;
 
     const bool has_valid_spirv{false};
-    const StaticData static_data_;
+    const StaticData &static_data_;
+
+  private:
+    // Must follow static_data_, as building it looks itself up through static_data_
+    const StaticData own_static_data_;
 
+  public:
     uint32_t gpu_validation_shader_id{std::numeric_limits<uint32_t>::max()};
 
     explicit SHADER_MODULE_STATE(vvl::span<const uint32_t> code)
         : BASE_NODE(static_cast<VkShaderModule>(VK_NULL_HANDLE), kVulkanObjectTypeShaderModule),
-          words_(code.begin(), code.end()),
-          static_data_(*this) {}
+          own_words_(code.begin(), code.end()),
+          words_(own_words_),
+          static_data_(own_static_data_),
+          own_static_data_(*this) {}
 
     SHADER_MODULE_STATE(const VkShaderModuleCreateInfo &create_info, VkShaderModule shaderModule, uint32_t unique_shader_id)
         : BASE_NODE(shaderModule, kVulkanObjectTypeShaderModule),
-          words_(create_info.pCode, create_info.pCode + create_info.codeSize / sizeof(uint32_t)),
+          own_words_(create_info.pCode, create_info.pCode + create_info.codeSize / sizeof(uint32_t)),
+          words_(own_words_),
+          has_valid_spirv(true),
+          static_data_(own_static_data_),
+          own_static_data_(*this),
+          gpu_validation_shader_id(unique_shader_id) {}
+
+    // Shares the words and StaticData of shared_module instead of parsing the code again
+    SHADER_MODULE_STATE(std::shared_ptr<const SHADER_MODULE_STATE> &&shared_module, VkShaderModule shaderModule,
+                        uint32_t unique_shader_id)
+        : BASE_NODE(shaderModule, kVulkanObjectTypeShaderModule),
+          shared_module_(std::move(shared_module)),
+          words_(shared_module_->words_),
           has_valid_spirv(true),
-          static_data_(*this),
+          static_data_(shared_module_->static_data_),
           gpu_validation_shader_id(unique_shader_id) {}
 
-    SHADER_MODULE_STATE() : BASE_NODE(static_cast<VkShaderModule>(VK_NULL_HANDLE), kVulkanObjectTypeShaderModule) {}
+    SHADER_MODULE_STATE()
+        : BASE_NODE(static_cast<VkShaderModule>(VK_NULL_HANDLE), kVulkanObjectTypeShaderModule),
+          words_(own_words_),
+          static_data_(own_static_data_) {}
 
     const Instruction *FindDef(uint32_t id) const {
-        auto it = static_data_.definitions.find(id);
-        if (it == static_data_.definitions.end()) return nullptr;
-        return it->second;
+        return (id < static_data_.definitions.size()) ? static_data_.definitions[id] : nullptr;
     }
 
     const std::vector<Instruction> &GetInstructions() const { return static_data_.instructions; }
@@ -523,7 +564,8 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
     const std::vector<const Instruction *> FindVariableAccesses(uint32_t variable_id, const std::vector<uint32_t> &access_ids,
                                                                 bool atomic) const;
 
-    bool HasMultipleEntryPoints() const { return static_data_.entry_points.size() > 1; }
+    bool HasMultipleEntryPoints() const { return static_data_.entry_point_inst.size() > 1; }
+    const std::vector<std::shared_ptr<EntryPoint>> &GetEntryPoints() const;
 
     VkShaderModule vk_shader_module() const { return handle_.Cast<VkShaderModule>(); }
 
@@ -541,8 +583,9 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
 
     std::shared_ptr<const TypeStructInfo> GetTypeStructInfo(uint32_t struct_id) const {
         // return the actual execution modes for this id, or a default empty set.
-        const auto it = static_data_.type_struct_map.find(struct_id);
-        return (it != static_data_.type_struct_map.end()) ? it->second : nullptr;
+        const auto &type_struct_map = GetTypeStructMap();
+        const auto it = type_struct_map.find(struct_id);
+        return (it != type_struct_map.end()) ? it->second : nullptr;
     }
     // Overload to walk down and find the OpTypeStruct
     std::shared_ptr<const TypeStructInfo> GetTypeStructInfo(const Instruction *insn) const {
@@ -601,6 +644,8 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
                                             std::vector<std::shared_ptr<EntryPoint>> &entry_points);
 
   private:
+    const vvl::unordered_map<uint32_t, std::shared_ptr<const TypeStructInfo>> &GetTypeStructMap() const;
+
     // The following are all helper functions to set the push constants values by tracking if the values are accessed in the entry
     // point functions and which offset in the structs are used
     uint32_t UpdateOffset(uint32_t offset, const std::vector<uint32_t> &array_indices, const StructInfo &data) const;
@@ -613,3 +658,40 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
     void SetUsedStructMember(const uint32_t variable_id, const vvl::unordered_set<uint32_t> &accessible_ids,
                              const StructInfo &data) const;
 };
+
+// Process-wide table of parsed SPIR-V, so identical code (the same SPIR-V created as several VkShaderModules, by several devices,
+// or inlined with VkShaderModuleCreateInfo in the stages of many pipelines) is parsed once and its read-only StaticData is shared.
+// The table only holds weak references, a parsed module is released with the last SHADER_MODULE_STATE using it.
+class SpirvModuleCache {
+  public:
+    struct Stats {
+        uint64_t parsed_modules = 0;     // modules whose code had to be parsed
+        uint64_t shared_modules = 0;     // modules that reused the parse of identical code
+        uint64_t shared_bytes = 0;       // SPIR-V bytes not stored again thanks to sharing
+        uint64_t parse_nanoseconds = 0;  // total time spent parsing
+        uint64_t live_parsed_modules = 0;
+    };
+
+    static SpirvModuleCache &Instance();
+
+    // Returns the parsed module for code (a handle-less SHADER_MODULE_STATE), parsing it if there is none alive
+    std::shared_ptr<const SHADER_MODULE_STATE> Get(vvl::span<const uint32_t> code);
+
+    // Totals since the process started, cumulative across all devices
+    Stats GetStats() const;
+
+  private:
+    using Bucket = std::vector<std::weak_ptr<const SHADER_MODULE_STATE>>;
+    std::shared_ptr<const SHADER_MODULE_STATE> FindModule(Bucket &bucket, vvl::span<const uint32_t> code);
+    void SweepExpired();
+
+    mutable std::mutex lock_;
+    // Keyed by the XXH32 of the code, collisions are told apart by comparing the words. The modules are allocated apart from
+    // their control blocks, so an expired entry only holds on to the control block until it is swept.
+    vvl::unordered_map<uint32_t, Bucket> modules_;
+    // Entries in modules_, and how many were left by the last sweep. All the buckets are swept each time the entries double,
+    // as a bucket is otherwise only swept when code with its hash is looked up again.
+    size_t entry_count_ = 0;
+    size_t swept_entry_count_ = 0;
+    Stats stats_;
+};
@@ -22,7 +22,9 @@
 
 #include "generated/vk_format_utils.h"
 #include "containers/custom_containers.h"
+#include "containers/range_index.h"
 #include "utils/vk_layer_utils.h"
+#include "utils/thread_pool.h"
 #include "generated/vk_typemap_helper.h"
 
 #include "generated/chassis.h"
@@ -365,6 +367,7 @@ void ValidationStateTracker::PostCallRecordCreateBuffer(VkDevice device, const V
             // address is used for GPU-AV and ray tracing buffer validation
             buffer_state->deviceAddress = opaque_capture_address->opaqueCaptureAddress;
             const auto address_range = buffer_state->DeviceAddressRange();
+            BufferAddressesChanged();
 
             buffer_address_map_.split_and_merge_insert(
                 {address_range, {buffer_state}}, [](auto &current_buffer_list, const auto &new_buffer) {
@@ -414,6 +417,12 @@ void ValidationStateTracker::PostCallRecordCreateBufferView(VkDevice device, con
     Add(std::make_shared<BUFFER_VIEW_STATE>(buffer_state, *pView, pCreateInfo, buffer_features));
 }
 
+std::shared_ptr<IMAGE_VIEW_STATE> ValidationStateTracker::CreateImageViewState(
+    const std::shared_ptr<IMAGE_STATE> &image_state, VkImageView iv, const VkImageViewCreateInfo *ci, VkFormatFeatureFlags2KHR ff,
+    const VkFilterCubicImageViewImageFormatPropertiesEXT &cubic_props) {
+    return std::make_shared<IMAGE_VIEW_STATE>(image_state, iv, ci, ff, cubic_props);
+}
+
 void ValidationStateTracker::PostCallRecordCreateImageView(VkDevice device, const VkImageViewCreateInfo *pCreateInfo,
                                                            const VkAllocationCallbacks *pAllocator, VkImageView *pView,
                                                            VkResult result) {
@@ -448,7 +457,7 @@ void ValidationStateTracker::PostCallRecordCreateImageView(VkDevice device, cons
         DispatchGetPhysicalDeviceImageFormatProperties2(physical_device, &image_format_info, &image_format_properties);
     }
 
-    Add(std::make_shared<IMAGE_VIEW_STATE>(image_state, *pView, pCreateInfo, format_features, filter_cubic_props));
+    Add(CreateImageViewState(image_state, *pView, pCreateInfo, format_features, filter_cubic_props));
 }
 
 void ValidationStateTracker::PreCallRecordCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
@@ -501,6 +510,7 @@ void ValidationStateTracker::PreCallRecordDestroyBuffer(VkDevice device, VkBuffe
 
         if (buffer_state->deviceAddress != 0) {
             const auto address_range = buffer_state->DeviceAddressRange();
+            BufferAddressesChanged();
 
             buffer_address_map_.erase_range_or_touch(address_range, [&buffer_state](auto &buffers) {
                 assert(!buffers.empty());
@@ -1684,6 +1694,37 @@ void ValidationStateTracker::CreateDevice(const VkDeviceCreateInfo *pCreateInfo)
             DispatchGetPhysicalDeviceQueueFamilyProperties2KHR(physical_device, &queue_family_count, props.data());
         }
     }
+
+    // The thread count includes the application thread making the call, so 0 (the default) and 1 validate pipelines serially.
+    // Turning off fine grained locking is meant for debugging, so it also turns off the worker threads.
+    if (fine_grained_locking) {
+        const std::string threads_string = GetLayerOptionOrEnvVar("khronos_validation.pipeline_validation_threads");
+        const uint32_t thread_count =
+            !threads_string.empty() ? static_cast<uint32_t>(std::strtoul(threads_string.c_str(), nullptr, 10)) : 0;
+        if (thread_count > 1) {
+            pipeline_worker_pool_ = ThreadPool::GetShared(thread_count - 1);
+        }
+    }
+}
+
+bool ValidationStateTracker::ForEachPipelineCreateIndex(uint32_t count, const std::function<bool(uint32_t)> &func) const {
+    bool skip = false;
+    if (!pipeline_worker_pool_ || count < kMinParallelPipelineCount) {
+        for (uint32_t i = 0; i < count; ++i) {
+            skip |= func(i);
+        }
+        return skip;
+    }
+
+    std::vector<DeferredLogMessages> messages(count);
+    pipeline_worker_pool_->ParallelFor(count, [&func, &messages](uint32_t i) {
+        DeferredLogScope deferred_log(messages[i]);
+        messages[i].MergeSkip(func(i));
+    });
+    for (uint32_t i = 0; i < count; ++i) {
+        skip |= messages[i].Emit(report_data);
+    }
+    return skip;
 }
 
 void ValidationStateTracker::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
@@ -1881,9 +1922,10 @@ void ValidationStateTracker::PreCallRecordQueueBindSparse(VkQueue queue, uint32_
         const VkBindSparseInfo &bind_info = pBindInfo[bind_idx];
         // Track objects tied to memory
         for (uint32_t j = 0; j < bind_info.bufferBindCount; j++) {
+            // Batches can hold many thousands of page binds for the same resource
+            auto buffer_state = Get<BUFFER_STATE>(bind_info.pBufferBinds[j].buffer);
             for (uint32_t k = 0; k < bind_info.pBufferBinds[j].bindCount; k++) {
                 auto sparse_binding = bind_info.pBufferBinds[j].pBinds[k];
-                auto buffer_state = Get<BUFFER_STATE>(bind_info.pBufferBinds[j].buffer);
                 auto mem_state = Get<DEVICE_MEMORY_STATE>(sparse_binding.memory);
                 if (buffer_state) {
                     buffer_state->BindMemory(buffer_state.get(), mem_state, sparse_binding.memoryOffset,
@@ -1892,9 +1934,9 @@ void ValidationStateTracker::PreCallRecordQueueBindSparse(VkQueue queue, uint32_
             }
         }
         for (uint32_t j = 0; j < bind_info.imageOpaqueBindCount; j++) {
+            auto image_state = Get<IMAGE_STATE>(bind_info.pImageOpaqueBinds[j].image);
             for (uint32_t k = 0; k < bind_info.pImageOpaqueBinds[j].bindCount; k++) {
                 auto sparse_binding = bind_info.pImageOpaqueBinds[j].pBinds[k];
-                auto image_state = Get<IMAGE_STATE>(bind_info.pImageOpaqueBinds[j].image);
                 auto mem_state = Get<DEVICE_MEMORY_STATE>(sparse_binding.memory);
                 if (image_state) {
                     // An Android special image cannot get VkSubresourceLayout until the image binds a memory.
@@ -1909,12 +1951,12 @@ void ValidationStateTracker::PreCallRecordQueueBindSparse(VkQueue queue, uint32_
             }
         }
         for (uint32_t j = 0; j < bind_info.imageBindCount; j++) {
+            auto image_state = Get<IMAGE_STATE>(bind_info.pImageBinds[j].image);
             for (uint32_t k = 0; k < bind_info.pImageBinds[j].bindCount; k++) {
                 auto sparse_binding = bind_info.pImageBinds[j].pBinds[k];
                 // TODO: This size is broken for non-opaque bindings, need to update to comprehend full sparse binding data
                 VkDeviceSize size = sparse_binding.extent.depth * sparse_binding.extent.height * sparse_binding.extent.width * 4;
                 VkDeviceSize offset = sparse_binding.offset.z * sparse_binding.offset.y * sparse_binding.offset.x * 4;
-                auto image_state = Get<IMAGE_STATE>(bind_info.pImageBinds[j].image);
                 auto mem_state = Get<DEVICE_MEMORY_STATE>(sparse_binding.memory);
                 if (image_state) {
                     // An Android special image cannot get VkSubresourceLayout until the image binds a memory.
@@ -2408,8 +2450,9 @@ bool ValidationStateTracker::PreCallValidateCreateGraphicsPipelines(VkDevice dev
     // Set up the state that CoreChecks, gpu_validation and later StateTracker Record will use.
     create_graphics_pipeline_api_state *cgpl_state = reinterpret_cast<create_graphics_pipeline_api_state *>(cgpl_state_data);
     cgpl_state->pCreateInfos = pCreateInfos;  // GPU validation can alter this, so we have to set a default value for the Chassis
-    cgpl_state->pipe_state.reserve(count);
-    for (uint32_t i = 0; i < count; i++) {
+    cgpl_state->pipe_state.resize(count);
+    skip |= ForEachPipelineCreateIndex(count, [this, pCreateInfos, cgpl_state](uint32_t i) {
+        bool pipe_skip = false;
         const auto &create_info = pCreateInfos[i];
         auto layout_state = Get<PIPELINE_LAYOUT_STATE>(create_info.layout);
         std::shared_ptr<const RENDER_PASS_STATE> render_pass;
@@ -2424,13 +2467,14 @@ bool ValidationStateTracker::PreCallValidateCreateGraphicsPipelines(VkDevice dev
             const bool is_graphics_lib = GetGraphicsLibType(create_info) != static_cast<VkGraphicsPipelineLibraryFlagsEXT>(0);
             const bool has_link_info = LvlFindInChain<VkPipelineLibraryCreateInfoKHR>(create_info.pNext) != nullptr;
             if (!is_graphics_lib && !has_link_info) {
-                skip = true;
+                pipe_skip = true;
             }
         }
         auto csm_states = (cgpl_state->shader_states.size() > i) ? &cgpl_state->shader_states[i] : nullptr;
-        cgpl_state->pipe_state.push_back(
-            CreateGraphicsPipelineState(&create_info, i, std::move(render_pass), std::move(layout_state), csm_states));
-    }
+        cgpl_state->pipe_state[i] =
+            CreateGraphicsPipelineState(&create_info, i, std::move(render_pass), std::move(layout_state), csm_states);
+        return pipe_skip;
+    });
     return skip;
 }
 
@@ -2461,12 +2505,13 @@ bool ValidationStateTracker::PreCallValidateCreateComputePipelines(VkDevice devi
                                                                    void *ccpl_state_data) const {
     auto *ccpl_state = reinterpret_cast<create_compute_pipeline_api_state *>(ccpl_state_data);
     ccpl_state->pCreateInfos = pCreateInfos;  // GPU validation can alter this, so we have to set a default value for the Chassis
-    ccpl_state->pipe_state.reserve(count);
-    for (uint32_t i = 0; i < count; i++) {
+    ccpl_state->pipe_state.resize(count);
+    ForEachPipelineCreateIndex(count, [this, pCreateInfos, ccpl_state](uint32_t i) {
         // Create and initialize internal tracking data structure
-        ccpl_state->pipe_state.push_back(
-            CreateComputePipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout)));
-    }
+        ccpl_state->pipe_state[i] =
+            CreateComputePipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout));
+        return false;
+    });
     return false;
 }
 
@@ -2498,12 +2543,13 @@ bool ValidationStateTracker::PreCallValidateCreateRayTracingPipelinesNV(VkDevice
                                                                         const VkAllocationCallbacks *pAllocator,
                                                                         VkPipeline *pPipelines, void *crtpl_state_data) const {
     auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_api_state *>(crtpl_state_data);
-    crtpl_state->pipe_state.reserve(count);
-    for (uint32_t i = 0; i < count; i++) {
+    crtpl_state->pipe_state.resize(count);
+    ForEachPipelineCreateIndex(count, [this, pCreateInfos, crtpl_state](uint32_t i) {
         // Create and initialize internal tracking data structure
-        crtpl_state->pipe_state.push_back(
-            CreateRayTracingPipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout)));
-    }
+        crtpl_state->pipe_state[i] =
+            CreateRayTracingPipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout));
+        return false;
+    });
     return false;
 }
 
@@ -2533,12 +2579,13 @@ bool ValidationStateTracker::PreCallValidateCreateRayTracingPipelinesKHR(VkDevic
                                                                          const VkAllocationCallbacks *pAllocator,
                                                                          VkPipeline *pPipelines, void *crtpl_state_data) const {
     auto crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_khr_api_state *>(crtpl_state_data);
-    crtpl_state->pipe_state.reserve(count);
-    for (uint32_t i = 0; i < count; i++) {
+    crtpl_state->pipe_state.resize(count);
+    ForEachPipelineCreateIndex(count, [this, pCreateInfos, crtpl_state](uint32_t i) {
         // Create and initialize internal tracking data structure
-        crtpl_state->pipe_state.push_back(
-            CreateRayTracingPipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout)));
-    }
+        crtpl_state->pipe_state[i] =
+            CreateRayTracingPipelineState(&pCreateInfos[i], i, Get<PIPELINE_LAYOUT_STATE>(pCreateInfos[i].layout));
+        return false;
+    });
     return false;
 }
 
@@ -4974,13 +5021,15 @@ std::shared_ptr<SHADER_MODULE_STATE> ValidationStateTracker::CreateShaderModuleS
     if ((create_info.pCode[0] != spv::MagicNumber)) {
         return std::make_shared<SHADER_MODULE_STATE>();  // not valid SPIR-V
     }
-    const auto module_state = std::make_shared<SHADER_MODULE_STATE>(create_info, handle, unique_shader_id);
-    if (module_state->static_data_.has_group_decoration) {
+    // Identical code is only parsed once, see SpirvModuleCache
+    auto parsed_module =
+        SpirvModuleCache::Instance().Get(vvl::make_span(create_info.pCode, create_info.codeSize / sizeof(uint32_t)));
+    if (parsed_module->static_data_.has_group_decoration) {
         spvtools::Optimizer optimizer(spirv_environment);
         optimizer.RegisterPass(spvtools::CreateFlattenDecorationPass());
         std::vector<uint32_t> optimized_binary;
         // Run optimizer to flatten decorations only, set skip_validation so as to not re-run validator
-        auto result = optimizer.Run(module_state->words_.data(), module_state->words_.size(), &optimized_binary,
+        auto result = optimizer.Run(parsed_module->words_.data(), parsed_module->words_.size(), &optimized_binary,
                                     spvtools::ValidatorOptions(), true);
 
         if (result) {
@@ -4993,7 +5042,7 @@ std::shared_ptr<SHADER_MODULE_STATE> ValidationStateTracker::CreateShaderModuleS
             return std::make_shared<SHADER_MODULE_STATE>(new_create_info, handle, unique_shader_id);
         }
     }
-    return module_state;
+    return std::make_shared<SHADER_MODULE_STATE>(std::move(parsed_module), handle, unique_shader_id);
 }
 
 void ValidationStateTracker::PostCallRecordCmdTraceRaysIndirect2KHR(VkCommandBuffer commandBuffer,
@@ -5686,10 +5735,101 @@ void ValidationStateTracker::PostCallRecordCmdDecodeVideoKHR(VkCommandBuffer com
     cb_state->DecodeVideo(pDecodeInfo);
 }
 
+struct ValidationStateTracker::BufferAddressIndex {
+    template <typename Map>
+    BufferAddressIndex(const Map &map, uint64_t map_generation) : ranges(map), generation(map_generation) {}
+
+    sparse_container::range_index<BufferAddressRange, small_vector<BUFFER_STATE_PTR, 1, size_t>> ranges;
+    uint64_t generation;
+};
+
+std::shared_ptr<const ValidationStateTracker::BufferAddressIndex> ValidationStateTracker::GetBufferAddressIndex() const {
+    auto index = std::atomic_load(&buffer_address_index_);
+    if (!index) {
+        // Rebuild under the writer lock, so concurrent lookups wait for a single rebuild and the map cannot change meanwhile
+        WriteLockGuard guard(buffer_address_lock_);
+        index = std::atomic_load(&buffer_address_index_);
+        if (!index) {
+            index = std::make_shared<const BufferAddressIndex>(buffer_address_map_, buffer_address_generation_.load());
+            std::atomic_store(&buffer_address_index_, index);
+        }
+    }
+    return index;
+}
+
+void ValidationStateTracker::BufferAddressesChanged() {
+    buffer_address_generation_.fetch_add(1, std::memory_order_release);
+    std::atomic_store(&buffer_address_index_, std::shared_ptr<const BufferAddressIndex>());
+    stale_buffer_address_lookups_.store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+ValidationStateTracker::BufferAddressLookup<T> ValidationStateTracker::FindBuffersByAddress(VkDeviceAddress address) const {
+    auto index = std::atomic_load(&buffer_address_index_);
+    if (!index) {
+        ReadLockGuard guard(buffer_address_lock_);
+        index = std::atomic_load(&buffer_address_index_);
+        // A search of the map costs about as much as one of the index, and building the index as one per range, so the rebuild
+        // is only worth it once the map has stayed the same for that many lookups
+        if (!index && stale_buffer_address_lookups_.fetch_add(1, std::memory_order_relaxed) < buffer_address_map_.size()) {
+            const auto it = buffer_address_map_.find(address);
+            if (it == buffer_address_map_.end()) {
+                return {};
+            }
+            // The map entry can change as soon as the lock is released, so the lookup holds on to its own copy of the buffers
+            auto buffers = std::make_shared<small_vector<BUFFER_STATE_PTR, 1, size_t>>(it->second);
+            return {buffers, buffers->data(), buffers->size()};
+        }
+    }
+    if (!index) {
+        index = GetBufferAddressIndex();
+    }
+    // The index is only read by the lookups, the buffer pointers are handed out as non-const for AddChildren
+    auto *entry = std::const_pointer_cast<BufferAddressIndex>(index)->ranges.find(address);
+    if (!entry) {
+        return {};
+    }
+    return {index, entry->second.data(), entry->second.size()};
+}
+
+ValidationStateTracker::BufferAddressLookup<ValidationStateTracker::BUFFER_STATE_PTR> ValidationStateTracker::GetBuffersByAddress(
+    VkDeviceAddress address) {
+    return FindBuffersByAddress<BUFFER_STATE_PTR>(address);
+}
+
+ValidationStateTracker::BufferAddressLookup<const ValidationStateTracker::BUFFER_STATE_PTR>
+ValidationStateTracker::GetBuffersByAddress(VkDeviceAddress address) const {
+    return FindBuffersByAddress<const BUFFER_STATE_PTR>(address);
+}
+
+std::vector<ValidationStateTracker::BufferAddressRange> ValidationStateTracker::GetBufferAddressRanges(uint64_t &generation) const {
+    std::vector<BufferAddressRange> result;
+    if (const auto index = std::atomic_load(&buffer_address_index_)) {
+        result.reserve(index->ranges.size());
+        for (const auto &entry : index->ranges.entries()) {
+            result.push_back(entry.first);
+        }
+        generation = index->generation;
+        return result;
+    }
+    // Copying the ranges out of the map costs the same as building the index, so don't build it here
+    ReadLockGuard guard(buffer_address_lock_);
+    result.reserve(buffer_address_map_.size());
+    for (const auto &entry : buffer_address_map_) {
+        result.push_back(entry.first);
+    }
+    generation = buffer_address_generation_.load();
+    return result;
+}
+
 void ValidationStateTracker::RecordGetBufferDeviceAddress(const VkBufferDeviceAddressInfo *pInfo, VkDeviceAddress address) {
     auto buffer_state = Get<BUFFER_STATE>(pInfo->buffer);
     if (buffer_state && address != 0) {
         WriteLockGuard guard(buffer_address_lock_);
+        // The address of a buffer never changes, so applications querying it again do not change the ranges
+        if (buffer_state->deviceAddress != address) {
+            BufferAddressesChanged();
+        }
         // address is used for GPU-AV and ray tracing buffer validation
         buffer_state->deviceAddress = address;
         const auto address_range = buffer_state->DeviceAddressRange();
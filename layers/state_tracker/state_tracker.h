@@ -65,6 +65,7 @@ class EVENT_STATE;
 class SWAPCHAIN_NODE;
 class SURFACE_STATE;
 class UPDATE_TEMPLATE_STATE;
+class ThreadPool;
 
 // These versions allow functions that are the same to share the same logic but can use different VUs
 // The common case are functions that were missing the pNext in Vulkan 1.0 and added via extension
@@ -447,34 +448,30 @@ class ValidationStateTracker : public ValidationObject {
     // device address. For purposes of valid usage, if multiple VkBuffer objects can be attributed to
     // a device address, a VkBuffer is selected such that valid usage passes, if it exists.
     using BUFFER_STATE_PTR = std::shared_ptr<BUFFER_STATE>;
-    vvl::span<BUFFER_STATE_PTR> GetBuffersByAddress(VkDeviceAddress address) {
-        ReadLockGuard guard(buffer_address_lock_);
-        auto found_it = buffer_address_map_.find(address);
-        if (found_it == buffer_address_map_.end()) {
-            return vvl::make_span<BUFFER_STATE_PTR>(nullptr, static_cast<size_t>(0));
-        }
-        return found_it->second;
-    }
+    // The buffers found at a device address. Holds on to the address index they were found in, so the span stays valid while
+    // other threads create and destroy buffers.
+    template <typename T>
+    class BufferAddressLookup : public vvl::span<T> {
+      public:
+        BufferAddressLookup() = default;
+        BufferAddressLookup(std::shared_ptr<const void> index, T* buffers, size_t count)
+            : vvl::span<T>(buffers, count), index_(std::move(index)) {}
 
-    vvl::span<const BUFFER_STATE_PTR> GetBuffersByAddress(VkDeviceAddress address) const {
-        ReadLockGuard guard(buffer_address_lock_);
-        auto found_it = buffer_address_map_.find(address);
-        if (found_it == buffer_address_map_.end()) {
-            return vvl::make_span<const BUFFER_STATE_PTR>(nullptr, static_cast<size_t>(0));
-        }
-        return found_it->second;
-    }
+      private:
+        std::shared_ptr<const void> index_;
+    };
+    BufferAddressLookup<BUFFER_STATE_PTR> GetBuffersByAddress(VkDeviceAddress address);
+    BufferAddressLookup<const BUFFER_STATE_PTR> GetBuffersByAddress(VkDeviceAddress address) const;
 
     using BufferAddressRange = sparse_container::range<VkDeviceAddress>;
     std::vector<BufferAddressRange> GetBufferAddressRanges() const {
-        ReadLockGuard guard(buffer_address_lock_);
-        std::vector<BufferAddressRange> result;
-        result.reserve(buffer_address_map_.size());
-        for (const auto& entry : buffer_address_map_) {
-            result.push_back(entry.first);
-        }
-        return result;
+        uint64_t generation;
+        return GetBufferAddressRanges(generation);
     }
+    // Also returns the generation of the ranges, see BufferAddressGeneration()
+    std::vector<BufferAddressRange> GetBufferAddressRanges(uint64_t& generation) const;
+    // Changes each time a buffer address range is added or removed, so copies of the ranges can tell when they are out of date
+    uint64_t BufferAddressGeneration() const { return buffer_address_generation_.load(std::memory_order_acquire); }
 
     using SetImageViewInitialLayoutCallback = std::function<void(CMD_BUFFER_STATE*, const IMAGE_VIEW_STATE&, VkImageLayout)>;
     template <typename Fn>
@@ -688,6 +685,10 @@ class ValidationStateTracker : public ValidationObject {
     void PostCallRecordResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolResetFlags flags,
                                         VkResult result) override;
 
+    // Calls func for each create info index of a vkCreate*Pipelines call. Large calls are split across the pipeline worker pool,
+    // with anything func logs emitted afterwards in index order. Returns the OR of the func results and the message callbacks.
+    bool ForEachPipelineCreateIndex(uint32_t count, const std::function<bool(uint32_t)>& func) const;
+
     virtual std::shared_ptr<PIPELINE_STATE> CreateComputePipelineState(const VkComputePipelineCreateInfo* pCreateInfo,
                                                                        uint32_t create_index,
                                                                        std::shared_ptr<const PIPELINE_LAYOUT_STATE>&& layout) const;
@@ -749,6 +750,9 @@ class ValidationStateTracker : public ValidationObject {
     void PostCallRecordCreateImage(VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator,
                                    VkImage* pImage, VkResult result) override;
     void PreCallRecordDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) override;
+    virtual std::shared_ptr<IMAGE_VIEW_STATE> CreateImageViewState(
+        const std::shared_ptr<IMAGE_STATE>& image_state, VkImageView iv, const VkImageViewCreateInfo* ci, VkFormatFeatureFlags2KHR ff,
+        const VkFilterCubicImageViewImageFormatPropertiesEXT& cubic_props);
     void PostCallRecordCreateImageView(VkDevice device, const VkImageViewCreateInfo* pCreateInfo,
                                        const VkAllocationCallbacks* pAllocator, VkImageView* pView, VkResult result) override;
     void PreCallRecordDestroyImageView(VkDevice device, VkImageView imageView, const VkAllocationCallbacks* pAllocator) override;
@@ -1603,6 +1607,22 @@ class ValidationStateTracker : public ValidationObject {
     // If vkGetBufferDeviceAddress is called, keep track of buffer <-> address mapping.
     sparse_container::range_map<VkDeviceAddress, small_vector<std::shared_ptr<BUFFER_STATE>, 1, size_t>> buffer_address_map_;
     mutable std::shared_mutex buffer_address_lock_;
+    std::atomic<uint64_t> buffer_address_generation_{0};
+    // Read-only copy of buffer_address_map_ used by the lookups, which don't take buffer_address_lock_ once it exists. It is
+    // dropped by every change of the map. Until it is rebuilt, lookups search the map under the reader lock, and the rebuild
+    // waits for about as many lookups as there are ranges (see FindBuffersByAddress), so applications that keep creating
+    // and destroying buffers don't pay for a copy of the map after each change. Only accessed with std::atomic_load /
+    // std::atomic_store. These are not lock-free for shared_ptr, the standard libraries guard them with an internal mutex or
+    // spinlock, but it is only held while the pointer is copied.
+    struct BufferAddressIndex;
+    mutable std::shared_ptr<const BufferAddressIndex> buffer_address_index_;
+    // Lookups that searched buffer_address_map_ since it last changed
+    mutable std::atomic<size_t> stale_buffer_address_lookups_{0};
+    std::shared_ptr<const BufferAddressIndex> GetBufferAddressIndex() const;
+    template <typename T>
+    BufferAddressLookup<T> FindBuffersByAddress(VkDeviceAddress address) const;
+    // Must be called with buffer_address_lock_ held for writing, whenever buffer_address_map_ changes
+    void BufferAddressesChanged();
 
     vl_concurrent_unordered_map<uint64_t, VkFormatFeatureFlags2KHR> ahb_ext_formats_map;
     std::atomic<VkDeviceSize> descriptorBufferAddressSpaceSize = {0u};
@@ -1623,6 +1643,10 @@ class ValidationStateTracker : public ValidationObject {
     mutable std::shared_mutex win32_handle_map_lock_;
 #endif
 
+    // Below this many create infos, splitting a vkCreate*Pipelines call across threads costs more than it saves
+    static constexpr uint32_t kMinParallelPipelineCount = 16;
+    std::shared_ptr<ThreadPool> pipeline_worker_pool_;
+
   private:
     VALSTATETRACK_MAP_AND_TRAITS(VkQueue, QUEUE_STATE, queue_map_)
     VALSTATETRACK_MAP_AND_TRAITS(VkAccelerationStructureNV, ACCELERATION_STRUCTURE_STATE, acceleration_structure_nv_map_)
@@ -0,0 +1,121 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sync/sync_stats.h"
+
+#include <cstdio>
+
+namespace syncval_stats {
+
+static const char *TimerName(Timer timer) {
+    switch (timer) {
+        case Timer::kDetectHazard:
+            return "detect_hazard";
+        case Timer::kUpdateAccessState:
+            return "update_access_state";
+        case Timer::kQueueSubmitValidate:
+            return "queue_submit_validate";
+        case Timer::kQueueSubmitRecord:
+            return "queue_submit_record";
+        case Timer::kQueueBatchTrim:
+            return "queue_batch_trim";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+static const char *CounterName(Counter counter) {
+    switch (counter) {
+        case Counter::kQueueSubmits:
+            return "queue_submits";
+        case Counter::kQueueBatchContextsCreated:
+            return "queue_batch_contexts_created";
+        case Counter::kExecutedCommandBuffers:
+            return "executed_command_buffers";
+        case Counter::kIncrementalTrims:
+            return "incremental_trims";
+        case Counter::kFullTrims:
+            return "full_trims";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+static const char *GaugeName(Gauge gauge) {
+    switch (gauge) {
+        case Gauge::kQueueBatchContexts:
+            return "queue_batch_contexts_alive";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+void Stats::WriteJson(std::ostream &out) const {
+    out << "\"counters\": {";
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Counter::kCount); ++i) {
+        out << (i ? ", " : "") << "\"" << CounterName(static_cast<Counter>(i))
+            << "\": " << counters_[i].load(std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Gauge::kCount); ++i) {
+        out << ", \"" << GaugeName(static_cast<Gauge>(i)) << "\": " << gauges_[i].load(std::memory_order_relaxed);
+    }
+    out << "}, \"timers\": {";
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Timer::kCount); ++i) {
+        const auto &entry = timers_[i];
+        out << (i ? ", " : "") << "\"" << TimerName(static_cast<Timer>(i))
+            << "\": {\"calls\": " << entry.calls.load(std::memory_order_relaxed)
+            << ", \"ns\": " << entry.nanoseconds.load(std::memory_order_relaxed) << "}";
+    }
+    out << "}";
+}
+
+void WriteJsonString(std::ostream &out, const std::string &value) {
+    out << '"';
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+}  // namespace syncval_stats
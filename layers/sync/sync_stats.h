@@ -0,0 +1,107 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Internal counters and timers for Synchronization Validation, enabled with khronos_validation.syncval_stats.
+//
+// Each SyncValidator owns the Stats of its device, created only when stats are enabled. The hot path hooks (hazard detection and
+// access state update) reach it through the AccessContext being operated on, so when disabled each hook costs a null pointer test.
+// Per device state (queues, batches, command buffers) is gathered by the SyncValidator when the report is written.
+namespace syncval_stats {
+
+enum class Timer : uint32_t {
+    kDetectHazard = 0,
+    kUpdateAccessState,
+    kQueueSubmitValidate,
+    kQueueSubmitRecord,
+    kQueueBatchTrim,
+    kCount
+};
+
+enum class Counter : uint32_t {
+    kQueueSubmits = 0,
+    kQueueBatchContextsCreated,
+    kExecutedCommandBuffers,
+    kIncrementalTrims,
+    kFullTrims,
+    kCount
+};
+
+enum class Gauge : uint32_t {
+    kQueueBatchContexts = 0,
+    kCount
+};
+
+class Stats {
+  public:
+    void Add(Counter counter, uint64_t value = 1) {
+        counters_[static_cast<uint32_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+    void Increment(Gauge gauge) { gauges_[static_cast<uint32_t>(gauge)].fetch_add(1, std::memory_order_relaxed); }
+    void Decrement(Gauge gauge) { gauges_[static_cast<uint32_t>(gauge)].fetch_sub(1, std::memory_order_relaxed); }
+    void AddTime(Timer timer, uint64_t nanoseconds) {
+        auto &entry = timers_[static_cast<uint32_t>(timer)];
+        entry.calls.fetch_add(1, std::memory_order_relaxed);
+        entry.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    // Writes the device counters as members of an enclosing JSON object
+    void WriteJson(std::ostream &out) const;
+
+    // Times the enclosing scope, if stats is set
+    class ScopedTimer {
+      public:
+        ScopedTimer(Stats *stats, Timer timer) : timer_(timer), stats_(stats) {
+            if (stats_) start_ = std::chrono::steady_clock::now();
+        }
+        ~ScopedTimer() {
+            if (stats_) {
+                const auto elapsed = std::chrono::steady_clock::now() - start_;
+                stats_->AddTime(timer_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            }
+        }
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+      private:
+        Timer timer_;
+        Stats *stats_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+  private:
+    struct TimerEntry {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> nanoseconds{0};
+    };
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::kCount)> counters_{};
+    std::array<std::atomic<int64_t>, static_cast<size_t>(Gauge::kCount)> gauges_{};
+    std::array<TimerEntry, static_cast<size_t>(Timer::kCount)> timers_;
+};
+
+// Writes value as a quoted JSON string, escaping quotes, backslashes and control characters
+void WriteJsonString(std::ostream &out, const std::string &value);
+
+}  // namespace syncval_stats
@@ -16,11 +16,16 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <limits>
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include "sync/sync_validation.h"
+#include "sync/sync_stats.h"
 #include "sync/sync_utils.h"
 
 // Utilities to DRY up Get... calls
@@ -267,7 +272,8 @@ std::ostream &operator<<(std::ostream &out, const ResourceUsageRecord::Formatter
             out << ", subcmd: " << record.sub_command;
         }
         // Note: ex_cb_state set to null forces output of record.cb_state
-        if (!formatter.ex_cb_state || (formatter.ex_cb_state != record.cb_state)) {
+        // Compacted records have no cb_state, and carry the command buffer handle in the handle list instead
+        if (record.cb_state && (!formatter.ex_cb_state || (formatter.ex_cb_state != record.cb_state))) {
             out << ", " << SyncNodeFormatter(formatter.sync_state, record.cb_state);
         }
         for (const auto &named_handle : record.handles) {
@@ -317,6 +323,23 @@ static void InitSubpassContexts(VkQueueFlags queue_flags, const RENDER_PASS_STAT
 }
 
 // NOTE: Make sure the proxy doesn't outlive from, as the proxy is pointing directly to access contexts owned by from.
+CommandBufferAccessContext::CommandBufferAccessContext(const SyncValidator *sync_validator)
+    : CommandExecutionContext(sync_validator),
+      cb_state_(),
+      access_log_(std::make_shared<AccessLog>()),
+      cbs_referenced_(std::make_shared<CommandBufferSet>()),
+      command_number_(0),
+      subcommand_number_(0),
+      reset_count_(0),
+      cb_access_context_(),
+      current_context_(&cb_access_context_),
+      events_context_(),
+      render_pass_contexts_(),
+      current_renderpass_context_(),
+      sync_ops_() {
+    if (sync_validator) cb_access_context_.SetStats(sync_validator->GetStats());
+}
+
 CommandBufferAccessContext::CommandBufferAccessContext(const CommandBufferAccessContext &from, AsProxyContext dummy)
     : CommandBufferAccessContext(from.sync_state_) {
     // Copy only the needed fields out of from for a temporary, proxy command buffer context
@@ -809,6 +832,7 @@ AccessContext::AccessContext(uint32_t subpass, VkQueueFlags queue_flags,
                              const std::vector<SubpassDependencyGraphNode> &dependencies,
                              const std::vector<AccessContext> &contexts, const AccessContext *external_context) {
     Reset();
+    if (external_context) stats_ = external_context->stats_;
     const auto &subpass_dep = dependencies[subpass];
     const bool has_barrier_from_external = subpass_dep.barrier_from_external.size() > 0U;
     prev_.reserve(subpass_dep.prev.size() + (has_barrier_from_external ? 1U : 0U));
@@ -837,7 +861,17 @@ AccessContext::AccessContext(uint32_t subpass, VkQueueFlags queue_flags,
     }
 }
 
+// Slack allowed for stale tags from overwritten ranges before an incremental trim falls back to a full one
+static constexpr size_t kIncrementalTrimTagSlack = 256;
+
 void AccessContext::Trim() {
+    if (trim_state_.enabled && !trim_state_.all_dirty &&
+        (trim_state_.referenced_tags.size() <= 2 * trim_state_.full_trim_tag_count + kIncrementalTrimTagSlack)) {
+        if (stats_) stats_->Add(syncval_stats::Counter::kIncrementalTrims);
+        IncrementalTrim();
+        return;
+    }
+
     auto normalize = [](AccessAddressType address_type, ResourceAccessRangeMap::value_type &access) { access.second.Normalize(); };
     ForAll(normalize);
 
@@ -845,9 +879,97 @@ void AccessContext::Trim() {
     for (auto &map : access_state_maps_) {
         sparse_container::consolidate(map);
     }
+
+    if (trim_state_.enabled) {
+        if (stats_) stats_->Add(syncval_stats::Counter::kFullTrims);
+        trim_state_.referenced_tags.clear();
+        auto gather = [this](AccessAddressType address_type, const ResourceAccessRangeMap::value_type &access) {
+            access.second.GatherReferencedTags(trim_state_.referenced_tags);
+        };
+        ConstForAll(gather);
+        trim_state_.full_trim_tag_count = trim_state_.referenced_tags.size();
+        for (auto &dirty : trim_state_.dirty) {
+            dirty.clear();
+        }
+        trim_state_.all_dirty = false;
+    }
+}
+
+void AccessContext::IncrementalTrim() {
+    for (const auto address_type : kAddressTypes) {
+        auto &dirty = trim_state_.dirty[static_cast<size_t>(address_type)];
+        if (dirty.empty()) continue;
+
+        // Coalesce the recorded ranges s.t. each access is visited at most once
+        std::sort(dirty.begin(), dirty.end(),
+                  [](const ResourceAccessRange &lhs, const ResourceAccessRange &rhs) { return lhs.begin < rhs.begin; });
+        auto &accesses = GetAccessStateMap(address_type);
+        auto trim_range = [this, &accesses](const ResourceAccessRange &range) {
+            for (auto pos = accesses.lower_bound(range); (pos != accesses.end()) && (pos->first.begin < range.end); ++pos) {
+                pos->second.Normalize();
+                pos->second.GatherReferencedTags(trim_state_.referenced_tags);
+            }
+            sparse_container::consolidate(accesses, range);
+        };
+
+        ResourceAccessRange pending = dirty.front();
+        for (const auto &range : dirty) {
+            if (range.begin <= pending.end) {
+                pending.end = std::max(pending.end, range.end);
+            } else {
+                trim_range(pending);
+                pending = range;
+            }
+        }
+        trim_range(pending);
+        dirty.clear();
+    }
+}
+
+bool AccessContext::HasDirtyRanges() const {
+    if (trim_state_.all_dirty) return true;
+    for (const auto &dirty : trim_state_.dirty) {
+        if (!dirty.empty()) return true;
+    }
+    return false;
+}
+
+void AccessContext::EnableIncrementalTrim(const AccessContext *copied_from) {
+    if (copied_from && copied_from->trim_state_.enabled) {
+        trim_state_ = copied_from->trim_state_;
+    } else {
+        trim_state_ = TrimState();
+        trim_state_.enabled = true;
+    }
+}
+
+void AccessContext::MarkDirty(AccessAddressType type, const ResourceAccessRange &range) {
+    if (trim_state_.enabled && !trim_state_.all_dirty && range.non_empty()) {
+        trim_state_.dirty[static_cast<size_t>(type)].emplace_back(range);
+    }
+}
+
+template <typename RangeGen>
+void AccessContext::MarkDirty(AccessAddressType type, RangeGen range_gen) {
+    if (!trim_state_.enabled || trim_state_.all_dirty) return;
+    for (; range_gen->non_empty(); ++range_gen) {
+        MarkDirty(type, *range_gen);
+    }
+}
+
+size_t AccessContext::RangeCount() const {
+    size_t count = 0;
+    for (const auto &map : access_state_maps_) {
+        count += map.size();
+    }
+    return count;
 }
 
 void AccessContext::AddReferencedTags(ResourceUsageTagSet &used) const {
+    if (trim_state_.enabled && !HasDirtyRanges()) {
+        used.insert(trim_state_.referenced_tags.begin(), trim_state_.referenced_tags.end());
+        return;
+    }
     auto gather = [&used](AccessAddressType address_type, const ResourceAccessRangeMap::value_type &access) {
         access.second.GatherReferencedTags(used);
     };
@@ -894,11 +1016,14 @@ void AccessContext::EraseIf(Predicate &&pred) {
         // Note: Don't forward, we don't want r-values moved, since we're going to make multiple calls.
         vvl::EraseIf(accesses, pred);
     }
+    // The predicate may update any access, and erasure may release referenced tags
+    MarkAllDirty();
 }
 
 template <typename Detector, typename RangeGen>
 HazardResult AccessContext::DetectHazard(AccessAddressType address_type, Detector &detector, RangeGen &range_gen,
                                          DetectOptions options) const {
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kDetectHazard);
     for (; range_gen->non_empty(); ++range_gen) {
         HazardResult hazard = DetectHazard(address_type, detector, *range_gen, options);
         if (hazard.hazard) return hazard;
@@ -1163,10 +1288,10 @@ template <typename BarrierAction>
 void AccessContext::ResolveAccessRange(const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type,
                                        BarrierAction &barrier_action, ResourceAccessRangeMap *descent_map,
                                        const ResourceAccessState *infill_state) const {
-    const std::optional<ImageRangeGen> &attachment_gen = view_gen.GetRangeGen(gen_type);
-    if (!attachment_gen) return;
+    const ImageRangeList *attachment_ranges = view_gen.GetRanges(gen_type);
+    if (!attachment_ranges) return;
 
-    subresource_adapter::ImageRangeGenerator range_gen(*attachment_gen);
+    ImageRangeList::Generator range_gen(*attachment_ranges);
     const AccessAddressType address_type = view_gen.GetAddressType();
     for (; range_gen->non_empty(); ++range_gen) {
         ResolveAccessRange(address_type, *range_gen, barrier_action, descent_map, infill_state);
@@ -1177,6 +1302,13 @@ template <typename ResolveOp>
 void AccessContext::ResolveFromContext(ResolveOp &&resolve_op, const AccessContext &from_context,
                                        const ResourceAccessState *infill_state, bool recur_to_infill) {
     for (auto address_type : kAddressTypes) {
+        if (infill_state || recur_to_infill) {
+            MarkAllDirty();
+        } else if (trim_state_.enabled && !trim_state_.all_dirty) {
+            for (const auto &access : from_context.GetAccessStateMap(address_type)) {
+                MarkDirty(address_type, access.first);
+            }
+        }
         from_context.ResolveAccessRange(address_type, kFullRange, resolve_op, &GetAccessStateMap(address_type), infill_state,
                                         recur_to_infill);
     }
@@ -1186,6 +1318,7 @@ template <typename ResolveOp, typename RangeGenerator>
 void AccessContext::ResolveFromContext(ResolveOp &&resolve_op, const AccessContext &from_context, AccessAddressType address_type,
                                        RangeGenerator range_gen, const ResourceAccessState *infill_state, bool recur_to_infill) {
     ResourceAccessRangeMap &destination_map = GetAccessStateMap(address_type);
+    MarkDirty(address_type, range_gen);
     for (; range_gen->non_empty(); ++range_gen) {
         from_context.ResolveAccessRange(address_type, *range_gen, resolve_op, &destination_map, infill_state, recur_to_infill);
     }
@@ -1417,6 +1550,7 @@ class HazardDetectorWithOrdering {
 HazardResult AccessContext::DetectHazard(const BUFFER_STATE &buffer, SyncStageAccessIndex usage_index,
                                          const ResourceAccessRange &range) const {
     if (!SimpleBinding(buffer)) return HazardResult();
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kDetectHazard);
     const auto base_address = ResourceBaseAddress(buffer);
     HazardDetector detector(usage_index);
     return DetectHazard(AccessAddressType::kLinear, detector, (range + base_address), DetectOptions::kDetectAll);
@@ -1425,10 +1559,10 @@ HazardResult AccessContext::DetectHazard(const BUFFER_STATE &buffer, SyncStageAc
 template <typename Detector>
 HazardResult AccessContext::DetectHazard(Detector &detector, const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type,
                                          DetectOptions options) const {
-    const std::optional<ImageRangeGen> &attachment_gen = view_gen.GetRangeGen(gen_type);
-    if (!attachment_gen) return HazardResult();
+    const ImageRangeList *attachment_ranges = view_gen.GetRanges(gen_type);
+    if (!attachment_ranges) return HazardResult();
 
-    subresource_adapter::ImageRangeGenerator range_gen(*attachment_gen);
+    ImageRangeList::Generator range_gen(*attachment_ranges);
     const auto address_type = view_gen.GetAddressType();
     return DetectHazard(address_type, detector, range_gen, options);
 }
@@ -1478,6 +1612,13 @@ HazardResult AccessContext::DetectHazard(const AttachmentViewGen &view_gen, Atta
     return DetectHazard(detector, view_gen, gen_type, DetectOptions::kDetectAll);
 }
 
+HazardResult AccessContext::DetectHazard(const IMAGE_STATE &image, const ImageRangeList &ranges,
+                                         SyncStageAccessIndex current_usage) const {
+    HazardDetector detector(current_usage);
+    ImageRangeList::Generator range_gen(ranges);
+    return DetectHazard(ImageAddressType(image), detector, range_gen, DetectOptions::kDetectAll);
+}
+
 HazardResult AccessContext::DetectHazard(const IMAGE_STATE &image, SyncStageAccessIndex current_usage,
                                          const VkImageSubresourceRange &subresource_range, SyncOrdering ordering_rule,
                                          const VkOffset3D &offset, const VkExtent3D &extent, bool is_depth_sliced) const {
@@ -1850,8 +1991,10 @@ class ResolvePendingBarrierFunctor : public ApplyBarrierOpsFunctor<NoopBarrierAc
 
 void AccessContext::UpdateAccessState(AccessAddressType type, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                                       const ResourceAccessRange &range, const ResourceUsageTag tag) {
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kUpdateAccessState);
     UpdateMemoryAccessStateFunctor action(type, *this, current_usage, ordering_rule, tag);
     UpdateMemoryAccessState(&GetAccessStateMap(type), range, action);
+    MarkDirty(type, range);
 }
 
 void AccessContext::UpdateAccessState(const BUFFER_STATE &buffer, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
@@ -1864,34 +2007,48 @@ void AccessContext::UpdateAccessState(const BUFFER_STATE &buffer, SyncStageAcces
 void AccessContext::UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                                       const VkImageSubresourceRange &subresource_range, const ResourceUsageTag &tag) {
     if (!SimpleBinding(image)) return;
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kUpdateAccessState);
     const auto base_address = ResourceBaseAddress(image);
     subresource_adapter::ImageRangeGenerator range_gen(*image.fragment_encoder.get(), subresource_range, base_address, false);
     const auto address_type = ImageAddressType(image);
     UpdateMemoryAccessStateFunctor action(address_type, *this, current_usage, ordering_rule, tag);
+    MarkDirty(address_type, range_gen);
     UpdateMemoryAccessState(&GetAccessStateMap(address_type), action, &range_gen);
 }
 void AccessContext::UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                                       const VkImageSubresourceRange &subresource_range, const VkOffset3D &offset,
                                       const VkExtent3D &extent, const ResourceUsageTag tag) {
     if (!SimpleBinding(image)) return;
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kUpdateAccessState);
     const auto base_address = ResourceBaseAddress(image);
     subresource_adapter::ImageRangeGenerator range_gen(*image.fragment_encoder.get(), subresource_range, offset, extent,
                                                        base_address, false);
     const auto address_type = ImageAddressType(image);
     UpdateMemoryAccessStateFunctor action(address_type, *this, current_usage, ordering_rule, tag);
+    MarkDirty(address_type, range_gen);
     UpdateMemoryAccessState(&GetAccessStateMap(address_type), action, &range_gen);
 }
 
 void AccessContext::UpdateAccessState(const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type,
                                       SyncStageAccessIndex current_usage, SyncOrdering ordering_rule, const ResourceUsageTag tag) {
-    const std::optional<ImageRangeGen> &gen = view_gen.GetRangeGen(gen_type);
-    if (!gen) return;
-    subresource_adapter::ImageRangeGenerator range_gen(*gen);
+    const ImageRangeList *ranges = view_gen.GetRanges(gen_type);
+    if (!ranges) return;
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kUpdateAccessState);
+    ImageRangeList::Generator range_gen(*ranges);
     const auto address_type = view_gen.GetAddressType();
     UpdateMemoryAccessStateFunctor action(address_type, *this, current_usage, ordering_rule, tag);
     ApplyUpdateAction(address_type, action, &range_gen);
 }
 
+void AccessContext::UpdateAccessState(const IMAGE_STATE &image, const ImageRangeList &ranges, SyncStageAccessIndex current_usage,
+                                      SyncOrdering ordering_rule, ResourceUsageTag tag) {
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kUpdateAccessState);
+    ImageRangeList::Generator range_gen(ranges);
+    const auto address_type = ImageAddressType(image);
+    UpdateMemoryAccessStateFunctor action(address_type, *this, current_usage, ordering_rule, tag);
+    ApplyUpdateAction(address_type, action, &range_gen);
+}
+
 void AccessContext::UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                                       const VkImageSubresourceLayers &subresource, const VkOffset3D &offset,
                                       const VkExtent3D &extent, const ResourceUsageTag tag) {
@@ -1903,14 +2060,17 @@ void AccessContext::UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessI
 template <typename Action, typename RangeGen>
 void AccessContext::ApplyUpdateAction(AccessAddressType address_type, const Action &action, RangeGen *range_gen_arg) {
     assert(range_gen_arg);  //  Old Google C++ styleguide require non-const object pass by * not &, but this isn't an optional arg.
+    MarkDirty(address_type, *range_gen_arg);
     UpdateMemoryAccessState(&GetAccessStateMap(address_type), action, range_gen_arg);
 }
 
 template <typename Action>
 void AccessContext::ApplyUpdateAction(const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type, const Action &action) {
-    const std::optional<ImageRangeGen> &gen = view_gen.GetRangeGen(gen_type);
-    if (!gen) return;
-    UpdateMemoryAccessState(&GetAccessStateMap(view_gen.GetAddressType()), action, *gen);
+    const ImageRangeList *ranges = view_gen.GetRanges(gen_type);
+    if (!ranges) return;
+    const ImageRangeList::Generator range_gen(*ranges);
+    MarkDirty(view_gen.GetAddressType(), range_gen);
+    UpdateMemoryAccessState(&GetAccessStateMap(view_gen.GetAddressType()), action, range_gen);
 }
 
 void AccessContext::UpdateAttachmentResolveAccess(const RENDER_PASS_STATE &rp_state,
@@ -1962,6 +2122,8 @@ void AccessContext::ApplyToContext(const Action &barrier_action) {
 }
 
 void AccessContext::ResolveChildContexts(const std::vector<AccessContext> &contexts) {
+    // Subpass contexts import the whole of their external context
+    MarkAllDirty();
     for (uint32_t subpass_index = 0; subpass_index < contexts.size(); subpass_index++) {
         auto &context = contexts[subpass_index];
         ApplyTrackbackStackAction barrier_action(context.GetDstExternalTrackBack().barriers);
@@ -2086,6 +2248,9 @@ bool CommandBufferAccessContext::ValidateDispatchDrawDescriptorSet(VkPipelineBin
                             hazard =
                                 current_context_->DetectHazard(*img_state, sync_index, subresource_range, SyncOrdering::kRaster,
                                                                offset, extent, img_view_state->IsDepthSliced());
+                        } else if (const auto *ranges =
+                                       static_cast<const syncval_state::ImageViewState *>(img_view_state)->GetDescriptorRanges()) {
+                            hazard = current_context_->DetectHazard(*img_state, *ranges, sync_index);
                         } else {
                             hazard = current_context_->DetectHazard(*img_state, sync_index, subresource_range,
                                                                     img_view_state->IsDepthSliced());
@@ -2215,6 +2380,10 @@ void CommandBufferAccessContext::RecordDispatchDrawDescriptorSet(VkPipelineBindP
                             const VkOffset3D offset = CastTo3D(cb_state_->activeRenderPassBeginInfo.renderArea.offset);
                             current_context_->UpdateAccessState(*img_state, sync_index, SyncOrdering::kRaster,
                                                                 img_view_state->normalized_subresource_range, offset, extent, tag);
+                        } else if (const auto *ranges =
+                                       static_cast<const syncval_state::ImageViewState *>(img_view_state)->GetDescriptorRanges()) {
+                            current_context_->UpdateAccessState(*img_state, *ranges, sync_index, SyncOrdering::kNonAttachment,
+                                                                tag);
                         } else {
                             current_context_->UpdateAccessState(*img_state, sync_index, SyncOrdering::kNonAttachment,
                                                                 img_view_state->normalized_subresource_range, tag);
@@ -2466,9 +2635,6 @@ bool CommandBufferAccessContext::ValidateFirstUse(CommandExecutionContext &exec_
 }
 
 void CommandBufferAccessContext::RecordExecutedCommandBuffer(const CommandBufferAccessContext &recorded_cb_context) {
-    const AccessContext *recorded_context = recorded_cb_context.GetCurrentAccessContext();
-    assert(recorded_context);
-
     // Just run through the barriers ignoring the usage from the recorded context, as Resolve will overwrite outdated state
     const ResourceUsageTag base_tag = GetTagLimit();
     for (const auto &sync_op : recorded_cb_context.GetSyncOps()) {
@@ -2479,7 +2645,7 @@ void CommandBufferAccessContext::RecordExecutedCommandBuffer(const CommandBuffer
 
     ResourceUsageRange tag_range = ImportRecordedAccessLog(recorded_cb_context);
     assert(base_tag == tag_range.begin);  // to ensure the to offset calculation agree
-    ResolveExecutedCommandBuffer(*recorded_context, tag_range.begin);
+    ResolveExecutedCommandBuffer(*recorded_cb_context.GetExecutionSummary(), tag_range.begin);
 }
 
 void CommandBufferAccessContext::ResolveExecutedCommandBuffer(const AccessContext &recorded_context, ResourceUsageTag offset) {
@@ -2487,6 +2653,30 @@ void CommandBufferAccessContext::ResolveExecutedCommandBuffer(const AccessContex
     GetCurrentAccessContext()->ResolveFromContext(tag_offset, recorded_context);
 }
 
+std::shared_ptr<const AccessContext> CommandBufferAccessContext::GetExecutionSummary() const {
+    std::lock_guard<std::mutex> guard(execution_summary_.lock);
+    const ResourceUsageTag tag_limit = GetTagLimit();
+    if (!execution_summary_.context || (execution_summary_.reset_count != reset_count_) ||
+        (execution_summary_.tag_limit != tag_limit)) {
+        // Flatten and consolidate the recorded state once, s.t. each execution only merges the minimal set of ranges.
+        // Note: unlike Trim, this must preserve the first access information needed by the executing command buffer.
+        auto summary = std::make_shared<AccessContext>();
+        const AccessContext *recorded_context = GetCurrentAccessContext();
+        assert(recorded_context);
+        summary->SetStats(recorded_context->GetStats());
+        const NoopBarrierAction noop_barrier;
+        for (AccessAddressType address_type : kAddressTypes) {
+            auto &summary_map = summary->GetAccessStateMap(address_type);
+            recorded_context->ResolveAccessRange(address_type, kFullRange, noop_barrier, &summary_map, nullptr);
+            sparse_container::consolidate(summary_map);
+        }
+        execution_summary_.context = std::move(summary);
+        execution_summary_.reset_count = reset_count_;
+        execution_summary_.tag_limit = tag_limit;
+    }
+    return execution_summary_.context;
+}
+
 HazardResult CommandBufferAccessContext::DetectFirstUseHazard(const ResourceUsageRange &tag_range) {
     return current_replay_->GetCurrentAccessContext()->DetectFirstUseHazard(GetQueueId(), tag_range, *GetCurrentAccessContext());
 }
@@ -2574,6 +2764,7 @@ class HazardDetectFirstUse {
 // hazards will be detected
 HazardResult AccessContext::DetectFirstUseHazard(QueueId queue_id, const ResourceUsageRange &tag_range,
                                                  const AccessContext &access_context) const {
+    syncval_stats::Stats::ScopedTimer timer(stats_, syncval_stats::Timer::kDetectHazard);
     HazardResult hazard;
     for (const auto address_type : kAddressTypes) {
         const auto &recorded_access_map = GetAccessStateMap(address_type);
@@ -4803,6 +4994,18 @@ void SyncValidator::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
     // The state tracker sets up the device state
     StateTracker::CreateDevice(pCreateInfo);
 
+    const std::string budget_string = GetLayerOptionOrEnvVar("khronos_validation.syncval_access_log_budget");
+    access_log_budget_ = !budget_string.empty() ? std::strtoull(budget_string.c_str(), nullptr, 10) : 0;
+
+    std::string stats_string = GetLayerOptionOrEnvVar("khronos_validation.syncval_stats");
+    std::transform(stats_string.begin(), stats_string.end(), stats_string.begin(), ::tolower);
+    if (!stats_string.compare("true")) {
+        stats_ = std::make_shared<syncval_stats::Stats>();
+        const std::string interval_string = GetLayerOptionOrEnvVar("khronos_validation.syncval_stats_submit_interval");
+        stats_report_interval_ = !interval_string.empty() ? std::strtoull(interval_string.c_str(), nullptr, 10) : 0;
+        stats_file_ = GetLayerOptionOrEnvVar("khronos_validation.syncval_stats_file");
+    }
+
     ForEachShared<QUEUE_STATE>([this](const std::shared_ptr<QUEUE_STATE> &queue_state) {
         auto queue_flags = physical_device_state->queue_family_properties[queue_state->queueFamilyIndex].queueFlags;
         std::shared_ptr<QueueSyncState> queue_sync_state =
@@ -4811,6 +5014,77 @@ void SyncValidator::CreateDevice(const VkDeviceCreateInfo *pCreateInfo) {
     });
 }
 
+void SyncValidator::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    if (stats_) {
+        ReportStats("destroy_device");
+    }
+    StateTracker::PreCallRecordDestroyDevice(device, pAllocator);
+}
+
+static void WriteAccessLogStats(std::ostream &out, const BatchAccessLog::Stats &stats) {
+    out << "{\"cb_logs\": " << stats.cb_logs << ", \"records\": " << stats.records
+        << ", \"compacted_records\": " << stats.compacted_records << ", \"evicted_records\": " << stats.evicted_records << "}";
+}
+
+// Write the internal statistics as a single line JSON object, to the stats file if set, otherwise as an info message
+void SyncValidator::ReportStats(const char *reason) const {
+    std::stringstream out;
+    out << "{\"reason\": \"" << reason << "\", \"device\": ";
+    syncval_stats::WriteJsonString(out, report_data->FormatHandle(device));
+    out << ", ";
+    stats_->WriteJson(out);
+
+    out << ", \"queues\": [";
+    bool first = true;
+    for (const auto &entry : queue_sync_states_) {
+        const QueueSyncState &queue_state = *entry.second;
+        const auto last_batch = queue_state.LastBatch();
+        out << (first ? "" : ", ") << "{\"queue_id\": " << queue_state.GetQueueId()
+            << ", \"ranges\": " << (last_batch ? last_batch->GetCurrentAccessContext()->RangeCount() : 0)
+            << ", \"access_log\": ";
+        WriteAccessLogStats(out, queue_state.GetAccessLogStats());
+        out << "}";
+        first = false;
+    }
+    out << "], \"signaled_semaphores\": [";
+    first = true;
+    for (const auto &signal : signaled_semaphores_) {
+        if (!signal.second || !signal.second->batch) continue;
+        const QueueBatchContext &batch = *signal.second->batch;
+        out << (first ? "" : ", ") << "{\"ranges\": " << batch.GetCurrentAccessContext()->RangeCount() << ", \"access_log\": ";
+        WriteAccessLogStats(out, batch.GetAccessLogStats());
+        out << "}";
+        first = false;
+    }
+    out << "], \"waitable_fences\": " << waitable_fences_.size();
+
+    // Command buffers may be concurrently recorded, so only walk them when the device is idle
+    if (!strcmp(reason, "destroy_device")) {
+        size_t cb_count = 0;
+        size_t cb_ranges = 0;
+        size_t cb_max_ranges = 0;
+        size_t cb_records = 0;
+        ForEachShared<CMD_BUFFER_STATE>([&](const std::shared_ptr<CMD_BUFFER_STATE> &cb_state) {
+            const auto &cb_access_context = static_cast<const syncval_state::CommandBuffer &>(*cb_state).access_context;
+            const size_t ranges = cb_access_context.GetCurrentAccessContext()->RangeCount();
+            cb_count++;
+            cb_ranges += ranges;
+            cb_max_ranges = std::max(cb_max_ranges, ranges);
+            cb_records += cb_access_context.GetTagLimit();
+        });
+        out << ", \"command_buffers\": {\"count\": " << cb_count << ", \"ranges\": " << cb_ranges
+            << ", \"max_ranges\": " << cb_max_ranges << ", \"records\": " << cb_records << "}";
+    }
+    out << "}";
+
+    if (!stats_file_.empty()) {
+        std::ofstream file(stats_file_, std::ios::app);
+        file << out.str() << std::endl;
+    } else {
+        LogInfo(device, "UNASSIGNED-SYNC-Stats", "%s", out.str().c_str());
+    }
+}
+
 bool SyncValidator::ValidateBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin,
                                             const VkSubpassBeginInfo *pSubpassBeginInfo, CMD_TYPE cmd_type) const {
     bool skip = false;
@@ -6769,6 +7043,8 @@ void SyncOpBarriers::ApplyBarriers(const Barriers &barriers, const FunctorFactor
             auto *const accesses = &context->GetAccessStateMap(GetAccessAddressType(*state));
             auto update_action = factory.MakeApplyFunctor(queue_id, barrier.barrier, barrier.IsLayoutTransition());
             auto range_gen = factory.MakeRangeGen(*state, barrier.Range());
+            // Layout transitions add write accesses. Global barriers don't need this, as they only update the barrier state.
+            context->MarkDirty(GetAccessAddressType(*state), range_gen);
             UpdateMemoryAccessState(accesses, update_action, &range_gen);
         }
     }
@@ -7700,13 +7976,11 @@ bool SyncValidator::PreCallValidateCmdExecuteCommands(VkCommandBuffer commandBuf
         if (!recorded_cb) continue;
         const auto *recorded_cb_context = &recorded_cb->access_context;
 
-        const auto *recorded_context = recorded_cb_context->GetCurrentAccessContext();
-        assert(recorded_context);
         skip |= recorded_cb_context->ValidateFirstUse(proxy_cb_context, "vkCmdExecuteCommands", cb_index);
 
         // The barriers have already been applied in ValidatFirstUse
         ResourceUsageRange tag_range = proxy_cb_context.ImportRecordedAccessLog(*recorded_cb_context);
-        proxy_cb_context.ResolveExecutedCommandBuffer(*recorded_context, tag_range.begin);
+        proxy_cb_context.ResolveExecutedCommandBuffer(*recorded_cb_context->GetExecutionSummary(), tag_range.begin);
     }
 
     return skip;
@@ -7726,6 +8000,7 @@ void SyncValidator::PreCallRecordCmdExecuteCommands(VkCommandBuffer commandBuffe
         cb_context->AddHandle(cb_tag, "pCommandBuffers", recorded_cb->Handle(), cb_index);
         const auto *recorded_cb_context = &recorded_cb->access_context;
         cb_context->RecordExecutedCommandBuffer(*recorded_cb_context);
+        if (stats_) stats_->Add(syncval_stats::Counter::kExecutedCommandBuffers);
     }
 }
 
@@ -7913,6 +8188,7 @@ bool SyncValidator::ValidateQueueSubmit(VkQueue queue, uint32_t submitCount, con
 
     // Since this early return is above the TlsGuard, the Record phase must also be.
     if (!enabled[sync_validation_queue_submit]) return skip;
+    syncval_stats::Stats::ScopedTimer timer(GetStats(), syncval_stats::Timer::kQueueSubmitValidate);
 
     vvl::TlsGuard<QueueSubmitCmdState> cmd_state(&skip, func_name, signaled_semaphores_);
     cmd_state->queue = GetQueueSyncStateShared(queue);
@@ -7970,6 +8246,7 @@ void SyncValidator::PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCoun
 void SyncValidator::RecordQueueSubmit(VkQueue queue, VkFence fence, VkResult result) {
     // If this return is above the TlsGuard, then the Validate phase return must also be.
     if (!enabled[sync_validation_queue_submit]) return;  // Queue submit validation must be affirmatively enabled
+    syncval_stats::Stats::ScopedTimer timer(GetStats(), syncval_stats::Timer::kQueueSubmitRecord);
 
     // The earliest return (when enabled), must be *after* the TlsGuard, as it is the TlsGuard that cleans up the cmd_state
     // static payload
@@ -7986,6 +8263,14 @@ void SyncValidator::RecordQueueSubmit(VkQueue queue, VkFence fence, VkResult res
 
     ResourceUsageRange fence_tag_range = ReserveGlobalTagRange(1U);
     UpdateFenceWaitInfo(fence, queue_state->GetQueueId(), fence_tag_range.begin);
+
+    if (stats_) {
+        stats_->Add(syncval_stats::Counter::kQueueSubmits);
+        const uint64_t submit_count = ++stats_submit_count_;
+        if (stats_report_interval_ && ((submit_count % stats_report_interval_) == 0)) {
+            ReportStats("submit");
+        }
+    }
 }
 
 bool SyncValidator::PreCallValidateQueueSubmit2KHR(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2KHR *pSubmits,
@@ -8029,37 +8314,113 @@ void SyncValidator::PostCallRecordWaitForFences(VkDevice device, uint32_t fenceC
     }
 }
 
+ImageRangeList::ImageRangeList(ImageRangeGen range_gen) {
+    for (; range_gen->non_empty(); ++range_gen) {
+        const ResourceAccessRange &range = *range_gen;
+        // Directly adjacent ranges (e.g. consecutive array layers) are merged, as they are equivalent for access tracking
+        if (!ranges_.empty() && (ranges_.back().end == range.begin)) {
+            ranges_.back().end = range.end;
+        } else {
+            ranges_.emplace_back(range);
+        }
+    }
+}
+
+syncval_state::ImageViewState::ImageViewState(const std::shared_ptr<IMAGE_STATE> &image_state, VkImageView iv,
+                                              const VkImageViewCreateInfo *ci, VkFormatFeatureFlags2KHR ff,
+                                              const VkFilterCubicImageViewImageFormatPropertiesEXT &cubic_props)
+    : IMAGE_VIEW_STATE(image_state, iv, ci, ff, cubic_props) {
+    if (!image_state || !SimpleBinding(*image_state)) return;
+    const auto *encoder = image_state->fragment_encoder.get();
+    if (!encoder) return;
+    const auto base_address = ResourceBaseAddress(*image_state);
+    const VkOffset3D offset = GetOffset();
+    const VkExtent3D extent = GetExtent();
+    const bool is_depth_sliced = IsDepthSliced();
+
+    // Intentional copy
+    VkImageSubresourceRange subres_range = normalized_subresource_range;
+    view_ranges_ = std::make_shared<ImageRangeList>(ImageRangeGen(*encoder, subres_range, offset, extent, base_address, is_depth_sliced));
+
+    const VkImageAspectFlags view_mask = subres_range.aspectMask;
+    const auto depth = view_mask & VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (depth && (depth != view_mask)) {
+        subres_range.aspectMask = depth;
+        depth_only_ranges_ =
+            std::make_shared<ImageRangeList>(ImageRangeGen(*encoder, subres_range, offset, extent, base_address, is_depth_sliced));
+    }
+    const auto stencil = view_mask & VK_IMAGE_ASPECT_STENCIL_BIT;
+    if (stencil && (stencil != view_mask)) {
+        subres_range.aspectMask = stencil;
+        stencil_only_ranges_ =
+            std::make_shared<ImageRangeList>(ImageRangeGen(*encoder, subres_range, offset, extent, base_address, is_depth_sliced));
+    }
+
+    if (!is_depth_sliced) {
+        descriptor_ranges_ =
+            std::make_unique<ImageRangeList>(ImageRangeGen(*encoder, normalized_subresource_range, base_address, false));
+    }
+}
+
+std::shared_ptr<IMAGE_VIEW_STATE> SyncValidator::CreateImageViewState(
+    const std::shared_ptr<IMAGE_STATE> &image_state, VkImageView iv, const VkImageViewCreateInfo *ci, VkFormatFeatureFlags2KHR ff,
+    const VkFilterCubicImageViewImageFormatPropertiesEXT &cubic_props) {
+    return std::make_shared<syncval_state::ImageViewState>(image_state, iv, ci, ff, cubic_props);
+}
+
+static bool IsSameOffsetAndExtent(const VkOffset3D &offset_a, const VkExtent3D &extent_a, const VkOffset3D &offset_b,
+                                  const VkExtent3D &extent_b) {
+    return (offset_a.x == offset_b.x) && (offset_a.y == offset_b.y) && (offset_a.z == offset_b.z) &&
+           (extent_a.width == extent_b.width) && (extent_a.height == extent_b.height) && (extent_a.depth == extent_b.depth);
+}
+
 AttachmentViewGen::AttachmentViewGen(const IMAGE_VIEW_STATE *view, const VkOffset3D &offset, const VkExtent3D &extent)
     : view_(view), view_mask_(), gen_store_() {
     if (!view_ || !view_->image_state || !SimpleBinding(*view_->image_state)) return;
+    const auto &view_state = *static_cast<const syncval_state::ImageViewState *>(view_);
+    if (!view_state.GetViewRanges()) return;
     const IMAGE_STATE &image_state = *view_->image_state.get();
     const auto base_address = ResourceBaseAddress(image_state);
     const auto *encoder = image_state.fragment_encoder.get();
-    if (!encoder) return;
     // Get offset and extent for the view, accounting for possible depth slicing
     const VkOffset3D zero_offset = view->GetOffset();
     const VkExtent3D &image_extent = view->GetExtent();
+    // The usual case of a render area covering the whole view can share the ranges precomputed by the view
+    const bool whole_view = IsSameOffsetAndExtent(offset, extent, zero_offset, image_extent);
     // Intentional copy
     VkImageSubresourceRange subres_range = view_->normalized_subresource_range;
     view_mask_ = subres_range.aspectMask;
-    gen_store_[Gen::kViewSubresource].emplace(*encoder, subres_range, zero_offset, image_extent, base_address,
-                                              view->IsDepthSliced());
-    gen_store_[Gen::kRenderArea].emplace(*encoder, subres_range, offset, extent, base_address, view->IsDepthSliced());
+    gen_store_[Gen::kViewSubresource] = view_state.GetViewRanges();
+    if (whole_view) {
+        gen_store_[Gen::kRenderArea] = view_state.GetViewRanges();
+    } else {
+        gen_store_[Gen::kRenderArea] = std::make_shared<ImageRangeList>(
+            ImageRangeGen(*encoder, subres_range, offset, extent, base_address, view->IsDepthSliced()));
+    }
 
     const auto depth = view_mask_ & VK_IMAGE_ASPECT_DEPTH_BIT;
     if (depth && (depth != view_mask_)) {
-        subres_range.aspectMask = depth;
-        gen_store_[Gen::kDepthOnlyRenderArea].emplace(*encoder, subres_range, offset, extent, base_address, view->IsDepthSliced());
+        if (whole_view) {
+            gen_store_[Gen::kDepthOnlyRenderArea] = view_state.GetDepthOnlyRanges();
+        } else {
+            subres_range.aspectMask = depth;
+            gen_store_[Gen::kDepthOnlyRenderArea] = std::make_shared<ImageRangeList>(
+                ImageRangeGen(*encoder, subres_range, offset, extent, base_address, view->IsDepthSliced()));
+        }
     }
     const auto stencil = view_mask_ & VK_IMAGE_ASPECT_STENCIL_BIT;
     if (stencil && (stencil != view_mask_)) {
-        subres_range.aspectMask = stencil;
-        gen_store_[Gen::kStencilOnlyRenderArea].emplace(*encoder, subres_range, offset, extent, base_address,
-                                                        view->IsDepthSliced());
+        if (whole_view) {
+            gen_store_[Gen::kStencilOnlyRenderArea] = view_state.GetStencilOnlyRanges();
+        } else {
+            subres_range.aspectMask = stencil;
+            gen_store_[Gen::kStencilOnlyRenderArea] = std::make_shared<ImageRangeList>(
+                ImageRangeGen(*encoder, subres_range, offset, extent, base_address, view->IsDepthSliced()));
+        }
     }
 }
 
-const std::optional<ImageRangeGen> &AttachmentViewGen::GetRangeGen(AttachmentViewGen::Gen type) const {
+const ImageRangeList *AttachmentViewGen::GetRanges(AttachmentViewGen::Gen type) const {
     static_assert(Gen::kGenSize == 4, "Function written with this assumption");
     // If the view is a depth only view, then the depth only portion of the render area is simply the render area.
     // If the view is a depth stencil view, then the depth only portion of the render area will be a subset,
@@ -8069,7 +8430,7 @@ const std::optional<ImageRangeGen> &AttachmentViewGen::GetRangeGen(AttachmentVie
     if (depth_only || stencil_only) {
         type = Gen::kRenderArea;
     }
-    return gen_store_[type];
+    return gen_store_[type].get();
 }
 
 AttachmentViewGen::Gen AttachmentViewGen::GetDepthStencilRenderAreaGenType(bool depth_op, bool stencil_op) const {
@@ -8140,7 +8501,9 @@ QueueBatchContext::QueueBatchContext(const SyncValidator &sync_state, const Queu
       current_access_context_(&access_context_),
       batch_log_(),
       queue_sync_tag_(sync_state.GetQueueIdLimit(), ResourceUsageTag(0)),
-      batch_(queue_state, submit_index, batch_index) {}
+      batch_(queue_state, submit_index, batch_index) {
+    InitStats();
+}
 
 QueueBatchContext::QueueBatchContext(const SyncValidator &sync_state)
     : CommandExecutionContext(&sync_state),
@@ -8149,9 +8512,25 @@ QueueBatchContext::QueueBatchContext(const SyncValidator &sync_state)
       current_access_context_(&access_context_),
       batch_log_(),
       queue_sync_tag_(sync_state.GetQueueIdLimit(), ResourceUsageTag(0)),
-      batch_() {}
+      batch_() {
+    InitStats();
+}
+
+QueueBatchContext::~QueueBatchContext() {
+    if (stats_) stats_->Decrement(syncval_stats::Gauge::kQueueBatchContexts);
+}
+
+void QueueBatchContext::InitStats() {
+    stats_ = GetSyncState().stats_;
+    access_context_.SetStats(stats_.get());
+    if (stats_) {
+        stats_->Add(syncval_stats::Counter::kQueueBatchContextsCreated);
+        stats_->Increment(syncval_stats::Gauge::kQueueBatchContexts);
+    }
+}
 
 void QueueBatchContext::Trim() {
+    syncval_stats::Stats::ScopedTimer timer(stats_.get(), syncval_stats::Timer::kQueueBatchTrim);
     // Clean up unneeded access context contents and log information
     access_context_.Trim();
 
@@ -8162,7 +8541,7 @@ void QueueBatchContext::Trim() {
     events_context_.AddReferencedTags(used_tags);
 
     // Only conserve AccessLog references that are referenced by used_tags
-    batch_log_.Trim(used_tags);
+    batch_log_.Trim(used_tags, GetSyncState().access_log_budget_);
 }
 
 void QueueBatchContext::ResolveSubmittedCommandBuffer(const AccessContext &recorded_context, ResourceUsageTag offset) {
@@ -8501,6 +8880,7 @@ void QueueBatchContext::SetupAccessContext(const PresentedImage &presented) {
 
 void QueueBatchContext::CommonSetupAccessContext(const std::shared_ptr<const QueueBatchContext> &prev,
                                                  QueueBatchContext::ConstBatchSet &batches_resolved) {
+    const AccessContext *copied_from = nullptr;
     // Import the previous batch information
     if (prev) {
         // Copy in the event state from the previous batch (on this queue)
@@ -8508,9 +8888,12 @@ void QueueBatchContext::CommonSetupAccessContext(const std::shared_ptr<const Que
         if (!vvl::Contains(batches_resolved, prev)) {
             // If there are no semaphores to the previous batch, make sure a "submit order" non-barriered import is done
             access_context_.ResolveFromContext(NoopBarrierAction(), prev->access_context_);
+            // With nothing else imported, the context is an exact copy of the previous one, and can continue its trim state
+            copied_from = batches_resolved.empty() ? &prev->access_context_ : nullptr;
             batches_resolved.emplace(prev);
         }
     }
+    access_context_.EnableIncrementalTrim(copied_from);
 
     // Get all the log and tag sync information for the resolved contexts
     for (const auto &batch : batches_resolved) {
@@ -8571,6 +8954,9 @@ std::string QueueBatchContext::FormatUsage(ResourceUsageTag tag) const {
 
         // Commandbuffer Usages Information
         out << ", " << record.Formatter(*sync_state_, nullptr);
+    } else if (batch_log_.IsEvicted(tag)) {
+        // Logs are only evicted when khronos_validation.syncval_access_log_budget is set
+        out << "usage record discarded (see khronos_validation.syncval_access_log_budget)";
     }
     return out.str();
 }
@@ -8735,6 +9121,11 @@ void BatchAccessLog::Import(const BatchAccessLog &other) {
     for (const auto &entry : other.log_map_) {
         log_map_.insert(entry);
     }
+    // Tag ranges are unique to a command buffer submission, so a log evicted from both batches has the same range in each, and
+    // the insert keeps a single entry for it
+    for (const auto &entry : other.evicted_logs_) {
+        evicted_logs_.insert(entry);
+    }
 }
 
 void BatchAccessLog::Insert(const BatchRecord &batch, const ResourceUsageRange &range,
@@ -8763,7 +9154,7 @@ void BatchAccessLog::Insert(const BatchRecord &batch, const ResourceUsageRange &
 // Note that for each subcase, any "next steps" logic is designed to be handled within the subsequent iteration -- meaning that
 // each subcase simply handles the specifics of the current update/skip/erase action needed, and leaves the iterators in a sensible
 // state for the top of loop... intentionally eliding special case handling.
-void BatchAccessLog::Trim(const ResourceUsageTagSet &used_tags) {
+void BatchAccessLog::Trim(const ResourceUsageTagSet &used_tags, size_t record_budget) {
     auto current_tag = used_tags.cbegin();
     const auto end_tag = used_tags.cend();
     auto current_map_range = log_map_.begin();
@@ -8795,6 +9186,66 @@ void BatchAccessLog::Trim(const ResourceUsageTagSet &used_tags) {
             }
         }
     }
+
+    // Drop the evicted logs no longer referenced, a tag can only be looked up while it is in use
+    for (auto evicted = evicted_logs_.begin(); evicted != evicted_logs_.end();) {
+        const auto used = used_tags.lower_bound(evicted->first.begin);
+        if ((used == end_tag) || (*used >= evicted->first.end)) {
+            evicted = evicted_logs_.erase(evicted);
+        } else {
+            ++evicted;
+        }
+    }
+
+    if (record_budget) {
+        Compact(used_tags, record_budget);
+    }
+}
+
+// Compact: Bound the number of ResourceUsageRecords retained by the BatchAccessLog
+//
+// Command buffer access logs are shared with the command buffer and with every batch that references them, and keep the command
+// buffer state alive. Oldest first, each log is replaced by a private copy of only the records still referenced, releasing the
+// shared references. If that isn't sufficient, the oldest logs are evicted entirely. Hazard detection doesn't depend on the log,
+// only hazard reporting does, so the prior usage of an evicted tag is reported as unavailable.
+void BatchAccessLog::Compact(const ResourceUsageTagSet &used_tags, size_t record_budget) {
+    size_t record_count = 0;
+    for (const auto &entry : log_map_) {
+        record_count += entry.second.Size();
+    }
+
+    for (auto it = log_map_.begin(); (it != log_map_.end()) && (record_count > record_budget); ++it) {
+        CBSubmitLog &submit_log = it->second;
+        if (submit_log.IsCompacted()) continue;
+        const size_t full_size = submit_log.Size();
+        submit_log = submit_log.Compact(it->first, used_tags);
+        record_count -= full_size - submit_log.Size();
+    }
+
+    auto evict_end = log_map_.begin();
+    while ((evict_end != log_map_.end()) && (record_count > record_budget)) {
+        const size_t evicted = evict_end->second.Size();
+        record_count -= evicted;
+        evicted_logs_.insert(std::make_pair(evict_end->first, evicted));
+        ++evict_end;
+    }
+    log_map_.erase(log_map_.begin(), evict_end);
+}
+
+BatchAccessLog::Stats BatchAccessLog::GetStats() const {
+    Stats stats;
+    stats.cb_logs = log_map_.size();
+    for (const auto &entry : log_map_) {
+        const size_t size = entry.second.Size();
+        stats.records += size;
+        if (entry.second.IsCompacted()) {
+            stats.compacted_records += size;
+        }
+    }
+    for (const auto &entry : evicted_logs_) {
+        stats.evicted_records += entry.second;
+    }
+    return stats;
 }
 
 BatchAccessLog::AccessRecord BatchAccessLog::operator[](ResourceUsageTag tag) const {
@@ -8802,18 +9253,47 @@ BatchAccessLog::AccessRecord BatchAccessLog::operator[](ResourceUsageTag tag) co
     if (found_log != log_map_.cend()) {
         return found_log->second[tag];
     }
-    assert("tag not found" == nullptr);
+    assert(IsEvicted(tag) && "tag not found");
     return AccessRecord();
 }
 
 BatchAccessLog::AccessRecord BatchAccessLog::CBSubmitLog::operator[](ResourceUsageTag tag) const {
     assert(tag >= batch_.bias);
-    const size_t index = tag - batch_.bias;
     assert(log_);
+    if (compacted_tags_) {
+        const auto found = std::lower_bound(compacted_tags_->cbegin(), compacted_tags_->cend(), tag);
+        if ((found == compacted_tags_->cend()) || (*found != tag)) {
+            return AccessRecord();
+        }
+        return AccessRecord{&batch_, &(*log_)[found - compacted_tags_->cbegin()]};
+    }
+    const size_t index = tag - batch_.bias;
     assert(index < log_->size());
     return AccessRecord{&batch_, &(*log_)[index]};
 }
 
+BatchAccessLog::CBSubmitLog BatchAccessLog::CBSubmitLog::Compact(const ResourceUsageRange &range,
+                                                                 const ResourceUsageTagSet &used) const {
+    auto tags = std::make_shared<std::vector<ResourceUsageTag>>();
+    auto log = std::make_shared<CommandExecutionContext::AccessLog>();
+    for (auto tag = used.lower_bound(range.begin); (tag != used.cend()) && (*tag < range.end); ++tag) {
+        const AccessRecord access = (*this)[*tag];
+        if (!access.IsValid()) continue;
+        ResourceUsageRecord record(*access.record);
+        if (record.cb_state) {
+            // The command buffer references are released, so only the handle can be kept for reporting
+            record.AddHandle("command_buffer", record.cb_state->Handle());
+            record.cb_state = nullptr;
+        }
+        tags->emplace_back(*tag);
+        log->emplace_back(record);
+    }
+
+    CBSubmitLog compacted(batch_, nullptr, std::move(log));
+    compacted.compacted_tags_ = std::move(tags);
+    return compacted;
+}
+
 PresentedImage::PresentedImage(const SyncValidator &sync_state, const std::shared_ptr<QueueBatchContext> batch_,
                                VkSwapchainKHR swapchain, uint32_t image_index_, uint32_t present_index_, ResourceUsageTag tag_)
     : PresentedImageRecord{tag_, image_index_, present_index_, sync_state.Get<syncval_state::Swapchain>(swapchain), {}},
@@ -8854,6 +9334,7 @@ void PresentedImage::UpdateMemoryAccess(SyncStageAccessIndex usage, ResourceUsag
     // Intentional copy. The range_gen argument is not copied by the Update... call below
     subresource_adapter::ImageRangeGenerator generator = range_gen;
     UpdateMemoryAccessStateFunctor action(address_type, access_context, usage, SyncOrdering::kNonAttachment, tag);
+    access_context.MarkDirty(address_type, generator);
     UpdateMemoryAccessState(&access_context.GetAccessStateMap(address_type), action, &generator);
 }
 
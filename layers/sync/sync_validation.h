@@ -19,6 +19,7 @@
 
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vulkan/vulkan.h>
 
@@ -43,6 +44,9 @@ namespace syncval_state {
 class CommandBuffer;
 class Swapchain;
 }  // namespace syncval_state
+namespace syncval_stats {
+class Stats;
+}  // namespace syncval_stats
 
 using ImageRangeGen = subresource_adapter::ImageRangeGenerator;
 
@@ -710,6 +714,64 @@ struct FenceSyncState {
     FenceSyncState(const std::shared_ptr<const FENCE_STATE> &fence_, const PresentedImage &image, ResourceUsageTag tag_);
 };
 
+// The address ranges produced by an image range generator, computed once for objects that reuse them, s.t. the per command
+// cost is a walk of a flat array instead of the per mip and array layer offset computation of the generator.
+class ImageRangeList {
+  public:
+    // A range generator over the list, with the same semantics as ImageRangeGenerator
+    class Generator {
+      public:
+        explicit Generator(const ImageRangeList &list)
+            : pos_(list.ranges_.data()), end_(list.ranges_.data() + list.ranges_.size()), current_() {
+            if (pos_ != end_) current_ = *pos_;
+        }
+        const ResourceAccessRange &operator*() const { return current_; }
+        const ResourceAccessRange *operator->() const { return &current_; }
+        Generator &operator++() {
+            ++pos_;
+            current_ = (pos_ < end_) ? *pos_ : ResourceAccessRange();
+            return *this;
+        }
+
+      private:
+        const ResourceAccessRange *pos_;
+        const ResourceAccessRange *end_;
+        ResourceAccessRange current_;
+    };
+
+    ImageRangeList() = default;
+    explicit ImageRangeList(ImageRangeGen range_gen);
+    size_t size() const { return ranges_.size(); }
+
+  private:
+    std::vector<ResourceAccessRange> ranges_;
+};
+
+namespace syncval_state {
+// Image view with the address ranges used by attachment and descriptor accesses precomputed at creation. The bound memory
+// of an image can't change once a view is created, so the ranges are valid for the life of the view.
+class ImageViewState : public IMAGE_VIEW_STATE {
+  public:
+    ImageViewState(const std::shared_ptr<IMAGE_STATE> &image_state, VkImageView iv, const VkImageViewCreateInfo *ci,
+                   VkFormatFeatureFlags2KHR ff, const VkFilterCubicImageViewImageFormatPropertiesEXT &cubic_props);
+
+    // The view subresource range over the view extent (the AttachmentViewGen::kViewSubresource ranges), with the depth and
+    // stencil only variants for combined depth/stencil views. Null if the image isn't simply bound.
+    const std::shared_ptr<const ImageRangeList> &GetViewRanges() const { return view_ranges_; }
+    const std::shared_ptr<const ImageRangeList> &GetDepthOnlyRanges() const { return depth_only_ranges_; }
+    const std::shared_ptr<const ImageRangeList> &GetStencilOnlyRanges() const { return stencil_only_ranges_; }
+    // The full view subresource range as accessed through descriptors. Null if the image isn't simply bound or depth sliced.
+    const ImageRangeList *GetDescriptorRanges() const { return descriptor_ranges_.get(); }
+
+  private:
+    std::shared_ptr<const ImageRangeList> view_ranges_;
+    std::shared_ptr<const ImageRangeList> depth_only_ranges_;
+    std::shared_ptr<const ImageRangeList> stencil_only_ranges_;
+    std::unique_ptr<const ImageRangeList> descriptor_ranges_;
+};
+}  // namespace syncval_state
+VALSTATETRACK_DERIVED_STATE_OBJECT(VkImageView, syncval_state::ImageViewState, IMAGE_VIEW_STATE);
+
 class AttachmentViewGen {
   public:
     enum Gen { kViewSubresource = 0, kRenderArea = 1, kDepthOnlyRenderArea = 2, kStencilOnlyRenderArea = 3, kGenSize = 4 };
@@ -718,14 +780,15 @@ class AttachmentViewGen {
     AttachmentViewGen(AttachmentViewGen &&other) = default;
     AccessAddressType GetAddressType() const;
     const IMAGE_VIEW_STATE *GetViewState() const { return view_; }
-    const std::optional<ImageRangeGen> &GetRangeGen(Gen type) const;
-    bool IsValid() const { return gen_store_[Gen::kViewSubresource].has_value(); }
+    const ImageRangeList *GetRanges(Gen type) const;
+    bool IsValid() const { return bool(gen_store_[Gen::kViewSubresource]); }
     Gen GetDepthStencilRenderAreaGenType(bool depth_op, bool stencil_op) const;
 
   private:
     const IMAGE_VIEW_STATE *view_ = nullptr;
     VkImageAspectFlags view_mask_ = 0U;
-    std::array<std::optional<ImageRangeGen>, Gen::kGenSize> gen_store_;
+    // The view lists are shared with the view state, the render area lists are only computed if the area isn't the whole view
+    std::array<std::shared_ptr<const ImageRangeList>, Gen::kGenSize> gen_store_;
 };
 
 using AttachmentViewGenVector = std::vector<AttachmentViewGen>;
@@ -1041,6 +1104,7 @@ class AccessContext {
                               const VkImageSubresourceRange &subresource_range, bool is_depth_sliced) const;
     HazardResult DetectHazard(const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type,
                               SyncStageAccessIndex current_usage, SyncOrdering ordering_rule) const;
+    HazardResult DetectHazard(const IMAGE_STATE &image, const ImageRangeList &ranges, SyncStageAccessIndex current_usage) const;
 
     HazardResult DetectHazard(const IMAGE_STATE &image, SyncStageAccessIndex current_usage,
                               const VkImageSubresourceRange &subresource_range, SyncOrdering ordering_rule,
@@ -1073,6 +1137,7 @@ class AccessContext {
         for (auto &map : access_state_maps_) {
             map.clear();
         }
+        trim_state_ = TrimState();
     }
 
     // Follow the context previous to access the access state, supporting "lazy" import into the context. Not intended for
@@ -1110,6 +1175,8 @@ class AccessContext {
                            ResourceUsageTag tag);
     void UpdateAccessState(const AttachmentViewGen &view_gen, AttachmentViewGen::Gen gen_type, SyncStageAccessIndex current_usage,
                            SyncOrdering ordering_rule, ResourceUsageTag tag);
+    void UpdateAccessState(const IMAGE_STATE &image, const ImageRangeList &ranges, SyncStageAccessIndex current_usage,
+                           SyncOrdering ordering_rule, ResourceUsageTag tag);
     void UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                            const VkImageSubresourceLayers &subresource, const VkOffset3D &offset, const VkExtent3D &extent,
                            ResourceUsageTag tag);
@@ -1134,8 +1201,20 @@ class AccessContext {
 
     AccessContext() { Reset(); }
     AccessContext(const AccessContext &copy_from) = default;
+    // Internal statistics of the device, null unless enabled. Copies and subpass contexts inherit it.
+    void SetStats(syncval_stats::Stats *stats) { stats_ = stats; }
+    syncval_stats::Stats *GetStats() const { return stats_; }
     void Trim();
     void AddReferencedTags(ResourceUsageTagSet &referenced) const;
+    size_t RangeCount() const;
+
+    // Once enabled, updates record the ranges they touch, and Trim only normalizes and consolidates those, carrying forward the
+    // referenced tags of the rest. If copied_from is set, this context is an exact copy of it and inherits its tracking state.
+    void EnableIncrementalTrim(const AccessContext *copied_from);
+    void MarkDirty(AccessAddressType type, const ResourceAccessRange &range);
+    template <typename RangeGen>
+    void MarkDirty(AccessAddressType type, RangeGen range_gen);
+    void MarkAllDirty() { trim_state_.all_dirty = true; }
 
     ResourceAccessRangeMap &GetAccessStateMap(AccessAddressType type) { return access_state_maps_[static_cast<size_t>(type)]; }
     const ResourceAccessRangeMap &GetAccessStateMap(AccessAddressType type) const {
@@ -1201,6 +1280,18 @@ class AccessContext {
     HazardResult DetectPreviousHazard(AccessAddressType type, Detector &detector, const ResourceAccessRange &range) const;
     void UpdateAccessState(AccessAddressType type, SyncStageAccessIndex current_usage, SyncOrdering ordering_rule,
                            const ResourceAccessRange &range, ResourceUsageTag tag);
+    void IncrementalTrim();
+    bool HasDirtyRanges() const;
+
+    struct TrimState {
+        bool enabled = false;
+        bool all_dirty = true;
+        std::array<std::vector<ResourceAccessRange>, static_cast<size_t>(AccessAddressType::kTypeCount)> dirty;
+        // Superset of the tags referenced by the contents, valid when enabled and nothing is dirty
+        ResourceUsageTagSet referenced_tags;
+        // Size of referenced_tags at the last full trim, bounding the growth of stale tags from overwritten ranges
+        size_t full_trim_tag_count = 0;
+    };
 
     MapArray access_state_maps_;
     std::vector<TrackBack> prev_;
@@ -1210,6 +1301,8 @@ class AccessContext {
     TrackBack *src_external_;
     TrackBack dst_external_;
     ResourceUsageTag start_tag_;
+    TrimState trim_state_;
+    syncval_stats::Stats *stats_ = nullptr;
 };
 
 struct SyncEventState {
@@ -1421,20 +1514,7 @@ class CommandBufferAccessContext : public CommandExecutionContext {
         SyncOpEntry(const SyncOpEntry &other) = default;
     };
 
-    CommandBufferAccessContext(const SyncValidator *sync_validator = nullptr)
-        : CommandExecutionContext(sync_validator),
-          cb_state_(),
-          access_log_(std::make_shared<AccessLog>()),
-          cbs_referenced_(std::make_shared<CommandBufferSet>()),
-          command_number_(0),
-          subcommand_number_(0),
-          reset_count_(0),
-          cb_access_context_(),
-          current_context_(&cb_access_context_),
-          events_context_(),
-          render_pass_contexts_(),
-          current_renderpass_context_(),
-          sync_ops_() {}
+    CommandBufferAccessContext(const SyncValidator *sync_validator = nullptr);
     CommandBufferAccessContext(SyncValidator &sync_validator, CMD_BUFFER_STATE *cb_state)
         : CommandBufferAccessContext(&sync_validator) {
         cb_state_ = cb_state;
@@ -1502,6 +1582,9 @@ class CommandBufferAccessContext : public CommandExecutionContext {
     bool ValidateFirstUse(CommandExecutionContext &exec_context, const char *func_name, uint32_t index) const;
     void RecordExecutedCommandBuffer(const CommandBufferAccessContext &recorded_context);
     void ResolveExecutedCommandBuffer(const AccessContext &recorded_context, ResourceUsageTag offset);
+    // Consolidated copy of the recorded access state (first accesses and final state per range), built once per recording
+    // and reused for each vkCmdExecuteCommands of this (secondary) command buffer.
+    std::shared_ptr<const AccessContext> GetExecutionSummary() const;
 
     HazardResult DetectFirstUseHazard(const ResourceUsageRange &tag_range) override;
 
@@ -1574,6 +1657,19 @@ class CommandBufferAccessContext : public CommandExecutionContext {
     std::vector<std::unique_ptr<RenderPassAccessContext>> render_pass_contexts_;
     RenderPassAccessContext *current_renderpass_context_;
     std::vector<SyncOpEntry> sync_ops_;
+
+    // Cache for GetExecutionSummary, keyed by the recording generation (reset count and tag limit).
+    // Never copied, as the proxy contexts are never executed as secondaries.
+    struct ExecutionSummary {
+        ExecutionSummary() = default;
+        ExecutionSummary(const ExecutionSummary &) {}
+        ExecutionSummary &operator=(const ExecutionSummary &) { return *this; }
+        std::mutex lock;
+        uint32_t reset_count = 0;
+        ResourceUsageTag tag_limit = 0;
+        std::shared_ptr<const AccessContext> context;
+    };
+    mutable ExecutionSummary execution_summary_;
 };
 
 namespace syncval_state {
@@ -1632,12 +1728,26 @@ class BatchAccessLog {
             : CBSubmitLog(batch, cb.GetCBReferencesShared(), cb.GetAccessLogShared()) {}
 
         size_t Size() const { return log_->size(); }
+        bool IsCompacted() const { return static_cast<bool>(compacted_tags_); }
         AccessRecord operator[](ResourceUsageTag tag) const;
 
+        // Replace the log with copies of only the records referenced by used_tags within range, releasing the references
+        // to the (potentially much larger) command buffer access logs and command buffer states.
+        CBSubmitLog Compact(const ResourceUsageRange &range, const ResourceUsageTagSet &used) const;
+
       private:
         BatchRecord batch_;
         std::shared_ptr<const CommandExecutionContext::CommandBufferSet> cbs_;
         std::shared_ptr<const CommandExecutionContext::AccessLog> log_;
+        // When compacted, the (sorted) global tags of the records retained in log_
+        std::shared_ptr<const std::vector<ResourceUsageTag>> compacted_tags_;
+    };
+
+    struct Stats {
+        size_t cb_logs = 0;
+        size_t records = 0;
+        size_t compacted_records = 0;
+        size_t evicted_records = 0;  // records of evicted logs that are still referenced
     };
 
     ResourceUsageTag Import(const BatchRecord &batch, const CommandBufferAccessContext &cb_access);
@@ -1645,14 +1755,23 @@ class BatchAccessLog {
     void Insert(const BatchRecord &batch, const ResourceUsageRange &range,
                 std::shared_ptr<const CommandExecutionContext::AccessLog> log);
 
-    void Trim(const ResourceUsageTagSet &used);
+    // A non-zero record_budget bounds the number of usage records retained, compacting and then evicting the oldest logs.
+    void Trim(const ResourceUsageTagSet &used, size_t record_budget = 0);
     // AccessRecord lookup is based on global tags
     AccessRecord operator[](ResourceUsageTag tag) const;
+    // True if the log holding tag was evicted to stay within the record budget
+    bool IsEvicted(ResourceUsageTag tag) const { return evicted_logs_.find(tag) != evicted_logs_.cend(); }
+    Stats GetStats() const;
     BatchAccessLog() {}
 
   private:
+    void Compact(const ResourceUsageTagSet &used, size_t record_budget);
+
     using CBSubmitLogRangeMap = sparse_container::range_map<ResourceUsageTag, CBSubmitLog>;
     CBSubmitLogRangeMap log_map_;
+    // Tag ranges of the logs evicted to stay within the record budget, with their record counts. Usage lookups for them are
+    // expected to fail. Trimmed like log_map_, so only the evicted logs that are still referenced are kept.
+    sparse_container::range_map<ResourceUsageTag, size_t> evicted_logs_;
 };
 
 struct PresentedImageRecord {
@@ -1762,7 +1881,9 @@ class QueueBatchContext : public CommandExecutionContext {
                       uint32_t batch_index);
     QueueBatchContext(const SyncValidator &sync_state);
     QueueBatchContext() = delete;
+    ~QueueBatchContext() override;
     void Trim();
+    BatchAccessLog::Stats GetAccessLogStats() const { return batch_log_.GetStats(); }
 
     std::string FormatUsage(ResourceUsageTag tag) const override;
     AccessContext *GetCurrentAccessContext() override { return current_access_context_; }
@@ -1823,6 +1944,9 @@ class QueueBatchContext : public CommandExecutionContext {
                                                                SignaledSemaphores &signaled);
 
     void ImportSyncTags(const QueueBatchContext &from);
+    void InitStats();
+    // Shared, as batches can be released after the SyncValidator in device teardown
+    std::shared_ptr<syncval_stats::Stats> stats_;
     const QueueSyncState *queue_state_ = nullptr;
     ResourceUsageRange tag_range_ = ResourceUsageRange(0, 0);  // Range of tags referenced by cbs_referenced
 
@@ -1859,6 +1983,9 @@ class QueueSyncState {
     const QUEUE_STATE *GetQueueState() const { return queue_state_.get(); }
     VkQueueFlags GetQueueFlags() const { return queue_flags_; }
     QueueId GetQueueId() const { return id_; }
+    BatchAccessLog::Stats GetAccessLogStats() const {
+        return last_batch_ ? last_batch_->GetAccessLogStats() : BatchAccessLog::Stats();
+    }
 
     uint64_t ReserveSubmitId() const;  // Method is const but updates mutable sumbit_index atomically.
 
@@ -1909,6 +2036,16 @@ class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
 
     vvl::unordered_map<VkQueue, std::shared_ptr<QueueSyncState>> queue_sync_states_;
     QueueId queue_id_limit_ = QueueSyncState::kQueueIdBase;
+    // Maximum number of usage records each QueueBatchContext retains for hazard reporting (0 is unlimited)
+    size_t access_log_budget_ = 0;
+
+    // Internal statistics reporting (khronos_validation.syncval_stats), stats_ is null when disabled
+    std::shared_ptr<syncval_stats::Stats> stats_;
+    syncval_stats::Stats *GetStats() const { return stats_.get(); }
+    uint64_t stats_report_interval_ = 0;
+    std::string stats_file_;
+    std::atomic<uint64_t> stats_submit_count_{0};
+    void ReportStats(const char *reason) const;
     SignaledSemaphores signaled_semaphores_;
 
     using SignaledFences = vvl::unordered_map<VkFence, FenceSyncState>;
@@ -1948,6 +2085,9 @@ class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
                                                            const COMMAND_POOL_STATE *cmd_pool) override;
     std::shared_ptr<SWAPCHAIN_NODE> CreateSwapchainState(const VkSwapchainCreateInfoKHR *create_info,
                                                          VkSwapchainKHR swapchain) final;
+    std::shared_ptr<IMAGE_VIEW_STATE> CreateImageViewState(const std::shared_ptr<IMAGE_STATE> &image_state, VkImageView iv,
+                                                           const VkImageViewCreateInfo *ci, VkFormatFeatureFlags2KHR ff,
+                                                           const VkFilterCubicImageViewImageFormatPropertiesEXT &cubic_props) final;
 
     void RecordCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin,
                                   const VkSubpassBeginInfo *pSubpassBeginInfo, CMD_TYPE cmd_type);
@@ -1957,6 +2097,7 @@ class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
     bool SupressedBoundDescriptorWAW(const HazardResult &hazard) const;
 
     void CreateDevice(const VkDeviceCreateInfo *pCreateInfo) override;
+    void PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) override;
 
     bool ValidateBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin,
                                  const VkSubpassBeginInfo *pSubpassBeginInfo, CMD_TYPE cmd_type) const;
@@ -0,0 +1,137 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/thread_pool.h"
+
+ThreadPool::ThreadPool(uint32_t worker_count) {
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::GetShared(uint32_t worker_count) {
+    static std::mutex shared_mutex;
+    static std::weak_ptr<ThreadPool> shared_pool;
+
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    auto pool = shared_pool.lock();
+    if (!pool) {
+        pool = std::make_shared<ThreadPool>(worker_count);
+        shared_pool = pool;
+    }
+    return pool;
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func) {
+    std::unique_lock<std::mutex> loop_lock(loop_mutex_, std::try_to_lock);
+    if (!loop_lock.owns_lock() || workers_.empty() || count < 2) {
+        for (uint32_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        func_ = &func;
+        count_ = count;
+        next_index_.store(0, std::memory_order_relaxed);
+        loop_open_ = true;
+        busy_workers_ = 0;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    RunIndices(func, count);
+
+    // Workers still busy with a task by now would find no indices left, so the loop is closed to them. The ones that joined have
+    // to check out before func goes out of scope.
+    std::unique_lock<std::mutex> lock(mutex_);
+    loop_open_ = false;
+    done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+    func_ = nullptr;
+}
+
+void ThreadPool::Enqueue(std::function<void()> &&task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace_back(std::move(task));
+    }
+    work_cv_.notify_one();
+}
+
+size_t ThreadPool::DiscardQueued() {
+    std::deque<std::function<void()>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        discarded.swap(tasks_);
+    }
+    // The tasks are destroyed outside of the lock, as destroying them may release state that takes locks of its own
+    return discarded.size();
+}
+
+void ThreadPool::WorkerMain() {
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [this, seen_generation] {
+            return stop_ || !tasks_.empty() || (loop_open_ && generation_ != seen_generation);
+        });
+        if (loop_open_ && generation_ != seen_generation) {
+            seen_generation = generation_;
+            ++busy_workers_;
+            const auto *func = func_;
+            const uint32_t count = count_;
+
+            lock.unlock();
+            RunIndices(*func, count);
+            lock.lock();
+
+            if (--busy_workers_ == 0) {
+                done_cv_.notify_one();
+            }
+        } else if (!tasks_.empty()) {
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        } else if (stop_) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::RunIndices(const std::function<void(uint32_t)> &func, uint32_t count) {
+    for (uint32_t i = next_index_.fetch_add(1, std::memory_order_relaxed); i < count;
+         i = next_index_.fetch_add(1, std::memory_order_relaxed)) {
+        func(i);
+    }
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// A small fixed set of worker threads used to split up expensive, independent validation work (such as the create infos of a
+// large vkCreate*Pipelines call). The pool runs one loop at a time; the calling thread always takes part in the loop.
+// Standalone tasks can also be queued with Submit(); workers pick them up whenever they are not taking part in a loop.
+class ThreadPool {
+  public:
+    explicit ThreadPool(uint32_t worker_count);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Returns the pool shared by all devices of the process, creating it with worker_count workers if there is none alive.
+    // The pool is destroyed (and its threads joined) when the last owner releases it.
+    static std::shared_ptr<ThreadPool> GetShared(uint32_t worker_count);
+
+    uint32_t WorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+    // Calls func(i) for every i in [0, count), and returns once all calls have completed. The order in which the indices are run
+    // is unspecified. If the pool is already running a loop for another thread, the loop runs on the calling thread alone.
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &func);
+
+    // Queues func to run on one of the workers, in submission order, and returns the future of its result. Tasks still queued
+    // when the pool is destroyed are run before the workers exit. Without workers, func runs on the calling thread.
+    template <typename Func>
+    std::future<std::invoke_result_t<Func>> Submit(Func &&func) {
+        using Result = std::invoke_result_t<Func>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        auto future = task->get_future();
+        if (workers_.empty()) {
+            (*task)();
+        } else {
+            Enqueue([task]() { (*task)(); });
+        }
+        return future;
+    }
+
+    // Drops the tasks that no worker has started yet, their futures get a broken_promise error. Returns how many were dropped.
+    size_t DiscardQueued();
+
+  private:
+    void Enqueue(std::function<void()> &&task);
+    void WorkerMain();
+    void RunIndices(const std::function<void(uint32_t)> &func, uint32_t count);
+
+    std::vector<std::thread> workers_;
+    std::mutex loop_mutex_;  // held by the thread that owns the current loop
+
+    std::mutex mutex_;  // guards everything below, other than next_index_
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(uint32_t)> *func_ = nullptr;
+    uint32_t count_ = 0;
+    uint64_t generation_ = 0;
+    bool loop_open_ = false;     // workers may still join the current loop
+    uint32_t busy_workers_ = 0;  // workers that joined the current loop and have not finished it
+    std::deque<std::function<void()>> tasks_;
+    bool stop_ = false;
+    std::atomic<uint32_t> next_index_{0};
+};
@@ -20,6 +20,7 @@
 #include "vk_layer_config.h"
 
 #include <string.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -98,7 +99,40 @@ std::string GetEnvironment(const char *variable) {
 #endif
 }
 
+std::string GetLayerCacheFilePath(const char *base_name) {
+    auto tmp_path = GetEnvironment("XDG_CACHE_HOME");
+    if (!tmp_path.size()) {
+        auto cachepath = GetEnvironment("HOME") + "/.cache";
+        struct stat info;
+        if (stat(cachepath.c_str(), &info) == 0) {
+            if ((info.st_mode & S_IFMT) == S_IFDIR) {
+                tmp_path = cachepath;
+            }
+        }
+    }
+    if (!tmp_path.size()) tmp_path = GetEnvironment("TMPDIR");
+    if (!tmp_path.size()) tmp_path = GetEnvironment("TMP");
+    if (!tmp_path.size()) tmp_path = GetEnvironment("TEMP");
+    if (!tmp_path.size()) tmp_path = "/tmp";
+    std::string path = tmp_path + "/" + base_name;
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+    path += "-" + std::to_string(getuid());
+#endif
+    return path + ".bin";
+}
+
 const char *getLayerOption(const char *option) { return layer_config.GetOption(option); }
+
+std::string GetLayerOptionOrEnvVar(const char *option) {
+    std::string env_var = option;
+    const size_t prefix_end = env_var.find('.');
+    if (prefix_end != std::string::npos) {
+        env_var.erase(0, prefix_end + 1);
+    }
+    std::transform(env_var.begin(), env_var.end(), env_var.begin(), ::toupper);
+    const std::string env_value = GetEnvironment(("VK_LAYER_" + env_var).c_str());
+    return env_value.empty() ? layer_config.GetOption(option) : env_value;
+}
 const char *GetLayerEnvVar(const char *option) {
     // NOTE: new code should use GetEnvironment directly. This is a workaround for the problem
     // described in https://github.com/KhronosGroup/Vulkan-ValidationLayers/issues/3048
@@ -31,6 +31,8 @@
 #endif
 
 std::string GetEnvironment(const char *variable);
+// Path of a per-user file named base_name in the user's cache directory (or the temporary directory if there is none)
+std::string GetLayerCacheFilePath(const char *base_name);
 
 enum SettingsFileSource {
     kVkConfig,
@@ -65,6 +67,9 @@ enum VkLayerDbgActionBits {
 using VkLayerDbgActionFlags = VkFlags;
 
 const char *getLayerOption(const char *option);
+// Returns the VK_LAYER_<NAME> environment variable when it is set, where NAME is the option without its "khronos_validation."
+// prefix in upper case, otherwise the value of the option
+std::string GetLayerOptionOrEnvVar(const char *option);
 const char *GetLayerEnvVar(const char *option);
 const SettingsFileInfo *GetLayerSettingsFileInfo();
 
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+# Copyright (c) 2023 The Khronos Group Inc.
+# Copyright (c) 2023 Valve Corporation
+# Copyright (c) 2023 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Turns a log written by Debug Printf with khronos_validation.printf_log_file set into the messages the layer would have reported.
+# The file layout is described in layers/gpu_validation/debug_printf_log.h, and the format strings are parsed the same way as
+# DebugPrintf::ParseFormatString does. Check the formatting with: python3 -m doctest scripts/debug_printf_decode.py
+import argparse
+import struct
+import sys
+
+FILE_MAGIC = 0x46505644
+FILE_VERSION = 2
+ENTRY_FORMAT_STRING = 1
+ENTRY_COMMAND = 2
+
+# Words of an output record, see DPFOutputRecord
+RECORD_SHADER_ID = 1
+RECORD_INSTRUCTION_POSITION = 2
+RECORD_STAGE = 3
+RECORD_STAGE_WORDS = 4
+RECORD_FORMAT_STRING_ID = 7
+RECORD_VALUES = 8
+
+STAGE_NAMES = {
+    0: 'Vertex', 1: 'Tessellation Control', 2: 'Tessellation Eval', 3: 'Geometry', 4: 'Fragment', 5: 'Compute',
+    5267: 'Task', 5268: 'Mesh', 5313: 'Ray Generation', 5314: 'Intersection', 5315: 'Any Hit', 5316: 'Closest Hit',
+    5317: 'Miss', 5318: 'Callable', 5364: 'Task', 5365: 'Mesh',
+}
+COMMAND_NAMES = {0: 'Draw', 1: 'Compute', 1000165000: 'Ray Trace'}
+TYPES = 'dioux' + 'XaAeEfFgGv'
+
+def value_kind(type_char):
+    if type_char in 'di':
+        return 'signed'
+    if type_char in 'aAeEfFgG':
+        return 'float'
+    return 'unsigned'
+
+# Returns the substrings of format_string, each holding at most one value, as (text, needs_value, kind)
+def parse_format_string(format_string):
+    substrings = []
+    pos = 0
+    begin = 0
+    while begin < len(format_string):
+        percent = pos = format_string.find('%', pos)
+        if pos == -1:
+            substrings.append((format_string[begin:], False, 'unsigned'))
+            break
+        pos += 1
+        if pos < len(format_string) and format_string[pos] == '%':
+            pos += 1
+            continue
+        while pos < len(format_string) and format_string[pos] not in TYPES:
+            pos += 1
+        if pos >= len(format_string):
+            pos = len(format_string)
+            continue
+        if format_string[pos] == 'v':
+            # %v<count><type>, printed as a comma separated list of count values
+            specifier = format_string[percent:pos]
+            count = int(format_string[pos + 1])
+            pos += 2
+            specifier += format_string[pos]
+            if pos + 1 < len(format_string) and format_string[pos + 1] == 'l':
+                specifier += 'l'
+                pos += 1
+            kind = value_kind(specifier[-1])
+            substrings.append((format_string[begin:percent] + specifier, True, kind))
+            substrings.extend([(', ' + specifier, True, kind)] * (count - 1))
+        else:
+            if pos + 1 < len(format_string) and format_string[pos + 1] == 'l':
+                pos += 1
+            substrings.append((format_string[begin:pos + 1], True, value_kind(format_string[pos])))
+        begin = pos + 1
+        pos = begin
+    return substrings
+
+def format_value(text, value):
+    # Python ignores the length modifiers, and has no %a
+    if '%a' in text or '%A' in text:
+        return text.replace('%a', '%s').replace('%A', '%s') % float.hex(value)
+    return text % value
+
+def format_record(format_string, words):
+    """Formats the values of an output record the way the layer does.
+
+    >>> format_record("Here's an integer %i and a float %1.2f", [0] * 8 + [0xffffff79, 0x40490e56])
+    "Here's an integer -135 and a float 3.14"
+    >>> format_record("Here's a vector of floats %1.2v2f", [0] * 8 + [0x3f99999a, 0x400ccccd])
+    "Here's a vector of floats 1.20, 2.20"
+    >>> format_record("%lx and %u%%", [0] * 8 + [0x89abcdef, 0x1234567, 7])
+    '123456789abcdef and 7%'
+    """
+    message = ''
+    values = words[RECORD_VALUES:]
+    index = 0
+    for text, needs_value, kind in parse_format_string(format_string):
+        long_specifier = next((s for s in ('%ul', '%lu', '%lx') if s in text), None)
+        if long_specifier:
+            # 64 bit values take two words, %ul and %lx print them in hex
+            value = values[index] | (values[index + 1] << 32)
+            index += 2
+            message += text.replace(long_specifier, '%u' if long_specifier == '%lu' else '%x') % value
+        elif needs_value:
+            word = values[index]
+            index += 1
+            if kind == 'signed':
+                message += format_value(text, struct.unpack('<i', struct.pack('<I', word))[0])
+            elif kind == 'float':
+                message += format_value(text, struct.unpack('<f', struct.pack('<I', word))[0])
+            else:
+                message += format_value(text, word)
+        else:
+            message += text % ()
+    return message
+
+def stage_message(words):
+    stage = words[RECORD_STAGE]
+    stage_words = words[RECORD_STAGE_WORDS:RECORD_STAGE_WORDS + 3]
+    if stage == 4:
+        x, y = struct.unpack('<ff', struct.pack('<II', stage_words[0], stage_words[1]))
+        details = f'Fragment coord (x,y) = ({x}, {y})'
+    else:
+        details = 'Stage info = (' + ', '.join(str(w) for w in stage_words) + ')'
+    return f'Stage = {STAGE_NAMES.get(stage, stage)}. {details}. '
+
+def read_words(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    return struct.unpack(f'<{len(data) // 4}I', data[:len(data) // 4 * 4])
+
+def decode(path, verbose, out):
+    words = read_words(path)
+    if len(words) < 2 or words[0] != FILE_MAGIC or words[1] != FILE_VERSION:
+        sys.exit(f'{path} is not a Debug Printf log')
+    format_strings = {}
+    offset = 2
+    while offset < len(words):
+        entry = words[offset]
+        if entry == ENTRY_FORMAT_STRING:
+            device_id, shader_id, string_id, length = words[offset + 1:offset + 5]
+            offset += 5
+            word_count = (length + 3) // 4
+            data = struct.pack(f'<{word_count}I', *words[offset:offset + word_count])
+            format_strings[(device_id, shader_id, string_id)] = data[:length].decode('utf-8', errors='replace')
+            offset += word_count
+        elif entry == ENTRY_COMMAND:
+            device_id, handle_low, handle_high, bind_point, operation_index, word_count = words[offset + 1:offset + 7]
+            offset += 7
+            records = words[offset:offset + word_count]
+            offset += word_count
+            index = 0
+            while index < len(records) and records[index] != 0:
+                record = records[index:index + records[index]]
+                index += records[index]
+                if len(record) <= RECORD_FORMAT_STRING_ID:
+                    break
+                key = (device_id, record[RECORD_SHADER_ID], record[RECORD_FORMAT_STRING_ID])
+                message = format_record(format_strings.get(key, ''), record)
+                if verbose:
+                    handle = handle_low | (handle_high << 32)
+                    command = COMMAND_NAMES.get(bind_point, 'Command')
+                    out.write(f'Device {device_id}. Command buffer (0x{handle:x}). {command} Index {operation_index}. '
+                              f'Shader ID = {record[RECORD_SHADER_ID]}. '
+                              f'Instruction Index = {record[RECORD_INSTRUCTION_POSITION]}. {stage_message(record)}')
+                out.write(message)
+                if verbose or not message.endswith('\n'):
+                    out.write('\n')
+        else:
+            sys.exit(f'Unknown entry {entry} at word {offset} of {path}')
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a Debug Printf log written with khronos_validation.printf_log_file.')
+    parser.add_argument('log_file', help='log file to decode')
+    parser.add_argument('--verbose', action='store_true', help='print the command and stage of each message')
+    args = parser.parse_args()
+    decode(args.log_file, args.verbose, sys.stdout)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "../framework/test_common.h"
+
+#include "containers/range_index.h"
+#include "containers/range_vector.h"
+
+#include <limits>
+#include <random>
+
+using TestRangeMap = sparse_container::range_map<uint64_t, int>;
+using TestRange = TestRangeMap::key_type;
+using TestRangeIndex = sparse_container::range_index<TestRange, int>;
+
+// Returns the value of the range including index, or -1, the slow way
+static int FindLinear(const TestRangeMap &map, uint64_t index) {
+    for (const auto &entry : map) {
+        if (entry.first.includes(index)) {
+            return entry.second;
+        }
+    }
+    return -1;
+}
+
+static int FindIndexed(const TestRangeIndex &range_index, uint64_t index) {
+    const auto *entry = range_index.find(index);
+    return entry ? entry->second : -1;
+}
+
+TEST(CustomContainer, RangeIndexEmpty) {
+    const TestRangeIndex default_index;
+    ASSERT_TRUE(default_index.empty());
+    ASSERT_EQ(default_index.find(0), nullptr);
+
+    const TestRangeIndex range_index{TestRangeMap()};
+    ASSERT_TRUE(range_index.empty());
+    ASSERT_EQ(range_index.find(0), nullptr);
+    ASSERT_EQ(range_index.find(std::numeric_limits<uint64_t>::max()), nullptr);
+}
+
+TEST(CustomContainer, RangeIndexBounds) {
+    TestRangeMap map;
+    map.insert(std::make_pair(TestRange(0, 4), 0));
+    map.insert(std::make_pair(TestRange(4, 8), 1));
+    map.insert(std::make_pair(TestRange(16, 17), 2));
+    map.insert(std::make_pair(TestRange(32, std::numeric_limits<uint64_t>::max()), 3));
+    const TestRangeIndex range_index(map);
+
+    ASSERT_EQ(range_index.size(), map.size());
+    size_t i = 0;
+    for (const auto &entry : map) {
+        ASSERT_EQ(range_index.entries()[i].first, entry.first);
+        ASSERT_EQ(range_index.entries()[i].second, entry.second);
+        ++i;
+    }
+
+    // The first and last index of each range, and the indices just past them
+    ASSERT_EQ(FindIndexed(range_index, 0), 0);
+    ASSERT_EQ(FindIndexed(range_index, 3), 0);
+    ASSERT_EQ(FindIndexed(range_index, 4), 1);
+    ASSERT_EQ(FindIndexed(range_index, 7), 1);
+    ASSERT_EQ(FindIndexed(range_index, 8), -1);
+    ASSERT_EQ(FindIndexed(range_index, 15), -1);
+    ASSERT_EQ(FindIndexed(range_index, 16), 2);
+    ASSERT_EQ(FindIndexed(range_index, 17), -1);
+    ASSERT_EQ(FindIndexed(range_index, 31), -1);
+    ASSERT_EQ(FindIndexed(range_index, 32), 3);
+    ASSERT_EQ(FindIndexed(range_index, std::numeric_limits<uint64_t>::max() - 1), 3);
+    ASSERT_EQ(FindIndexed(range_index, std::numeric_limits<uint64_t>::max()), -1);
+}
+
+TEST(CustomContainer, RangeIndexMatchesLinearSearch) {
+    std::mt19937_64 random(1234);
+    // Every tree shape up to a few levels, complete or not, then some larger ones
+    for (uint32_t range_count : {1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 15u, 16u, 17u, 31u, 100u, 1000u}) {
+        TestRangeMap map;
+        uint64_t begin = random() % 8;
+        for (uint32_t i = 0; i < range_count; ++i) {
+            const uint64_t end = begin + 1 + random() % 8;
+            map.insert(std::make_pair(TestRange(begin, end), static_cast<int>(i)));
+            // Leave a gap after some ranges
+            begin = end + ((random() % 2) ? random() % 8 : 0);
+        }
+        const TestRangeIndex range_index(map);
+        ASSERT_EQ(range_index.size(), range_count);
+        for (uint64_t index = 0; index <= begin + 8; ++index) {
+            ASSERT_EQ(FindIndexed(range_index, index), FindLinear(map, index)) << range_count << " ranges, index " << index;
+        }
+    }
+}
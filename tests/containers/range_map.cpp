@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023 The Khronos Group Inc.
+ * Copyright (c) 2023 Valve Corporation
+ * Copyright (c) 2023 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "../framework/test_common.h"
+
+#include "containers/range_vector.h"
+
+#include <tuple>
+#include <vector>
+
+using TestRangeMap = sparse_container::range_map<uint32_t, int>;
+using TestRange = TestRangeMap::key_type;
+using TestEntries = std::vector<std::tuple<uint32_t, uint32_t, int>>;
+
+static TestRangeMap MakeRangeMap(const TestEntries &entries) {
+    TestRangeMap map;
+    for (const auto &entry : entries) {
+        map.insert(std::make_pair(TestRange(std::get<0>(entry), std::get<1>(entry)), std::get<2>(entry)));
+    }
+    return map;
+}
+
+static TestEntries GetEntries(const TestRangeMap &map) {
+    TestEntries entries;
+    for (const auto &entry : map) {
+        entries.emplace_back(entry.first.begin, entry.first.end, entry.second);
+    }
+    return entries;
+}
+
+TEST(CustomContainer, RangeMapConsolidateBoundsEmpty) {
+    TestRangeMap map;
+    sparse_container::consolidate(map, TestRange(0, 16));
+    ASSERT_TRUE(map.empty());
+    sparse_container::consolidate(map);
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(CustomContainer, RangeMapConsolidateBoundsAtMapEdges) {
+    const TestEntries entries = {{0, 2, 1}, {2, 4, 1}, {4, 6, 2}, {6, 8, 2}};
+
+    // Bounds at the start of the map only merge the leading entries
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(0, 2));
+        const TestEntries expected = {{0, 4, 1}, {4, 6, 2}, {6, 8, 2}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // Bounds at the end of the map only merge the trailing entries
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(6, 8));
+        const TestEntries expected = {{0, 2, 1}, {2, 4, 1}, {4, 8, 2}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // Bounds past either end of the map only reach the adjacent entry
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(8, 16));
+        ASSERT_EQ(GetEntries(map), entries);
+    }
+    {
+        auto map = MakeRangeMap({{4, 6, 2}, {6, 8, 2}, {8, 10, 3}, {10, 12, 3}});
+        sparse_container::consolidate(map, TestRange(0, 4));
+        const TestEntries expected = {{4, 8, 2}, {8, 10, 3}, {10, 12, 3}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // Bounds covering the whole map match the unbounded consolidate
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(0, 8));
+        const TestEntries expected = {{0, 4, 1}, {4, 8, 2}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+}
+
+TEST(CustomContainer, RangeMapConsolidateBoundsWithinEntry) {
+    const TestEntries entries = {{0, 4, 1}, {4, 8, 1}, {8, 12, 2}, {12, 16, 2}, {16, 20, 2}};
+
+    // Bounds strictly inside an entry merge it with its equal neighbors, but don't start merges past the bounds
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(5, 6));
+        const TestEntries expected = {{0, 8, 1}, {8, 12, 2}, {12, 16, 2}, {16, 20, 2}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // Bounds cutting through two entries include both
+    {
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(10, 13));
+        const TestEntries expected = {{0, 4, 1}, {4, 8, 1}, {8, 20, 2}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+}
+
+TEST(CustomContainer, RangeMapConsolidateBoundsAcrossBoundary) {
+    // A merge starting within bounds continues past the end of the bounds
+    {
+        auto map = MakeRangeMap({{0, 4, 1}, {4, 8, 1}, {8, 12, 1}, {12, 16, 3}, {16, 20, 3}});
+        sparse_container::consolidate(map, TestRange(4, 8));
+        const TestEntries expected = {{0, 12, 1}, {12, 16, 3}, {16, 20, 3}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // The entry preceding the bounds merges into the first entry within them
+    {
+        auto map = MakeRangeMap({{0, 4, 3}, {4, 8, 3}, {8, 12, 1}, {12, 16, 1}});
+        sparse_container::consolidate(map, TestRange(12, 16));
+        const TestEntries expected = {{0, 4, 3}, {4, 8, 3}, {8, 16, 1}};
+        ASSERT_EQ(GetEntries(map), expected);
+    }
+    // Entries separated by a gap or with different values aren't merged
+    {
+        const TestEntries entries = {{0, 4, 1}, {5, 8, 1}, {8, 12, 2}};
+        auto map = MakeRangeMap(entries);
+        sparse_container::consolidate(map, TestRange(0, 12));
+        ASSERT_EQ(GetEntries(map), entries);
+    }
+}
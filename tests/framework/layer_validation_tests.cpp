@@ -184,6 +184,47 @@ void UpdateDescriptor(ThreadTestData *data) {
 
 #endif  // GTEST_IS_THREADSAFE
 
+ScopedEnvironmentVariable::ScopedEnvironmentVariable(const char *name, const char *value) : name_(name) {
+#if defined(_WIN32)
+    char previous_value[4096];
+    const DWORD size = GetEnvironmentVariableA(name, previous_value, sizeof(previous_value));
+    if (size > 0 && size < sizeof(previous_value)) {
+        previous_value_ = previous_value;
+        was_set_ = true;
+    }
+    SetEnvironmentVariableA(name, value);
+#else
+    if (const char *previous_value = getenv(name)) {
+        previous_value_ = previous_value;
+        was_set_ = true;
+    }
+    setenv(name, value, 1);
+#endif
+}
+
+ScopedEnvironmentVariable::~ScopedEnvironmentVariable() {
+#if defined(_WIN32)
+    SetEnvironmentVariableA(name_.c_str(), was_set_ ? previous_value_.c_str() : nullptr);
+#else
+    if (was_set_) {
+        setenv(name_.c_str(), previous_value_.c_str(), 1);
+    } else {
+        unsetenv(name_.c_str());
+    }
+#endif
+}
+
+ScopedTempDirectory::ScopedTempDirectory(const char *name) : path_(std::filesystem::path(::testing::TempDir()) / name) {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+    std::filesystem::create_directories(path_, error);
+}
+
+ScopedTempDirectory::~ScopedTempDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+}
+
 bool ThreadTimeoutHelper::WaitForThreads(int timeout_in_seconds) {
     std::unique_lock lock(mutex_);
     return cv_.wait_for(lock, std::chrono::seconds{timeout_in_seconds}, [this] { return active_threads_ == 0; });
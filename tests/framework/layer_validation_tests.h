@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -874,6 +875,37 @@ class ThreadTimeoutHelper {
     std::mutex mutex_;
 };
 
+// Sets an environment variable until the object is destroyed, then restores its previous value. Lets tests give the layer the
+// options it reads with GetLayerOptionOrEnvVar, as long as it is set before the device is created. Android layers read system
+// properties instead, so it has no effect there.
+class ScopedEnvironmentVariable {
+  public:
+    ScopedEnvironmentVariable(const char *name, const char *value);
+    ~ScopedEnvironmentVariable();
+    ScopedEnvironmentVariable(const ScopedEnvironmentVariable &) = delete;
+    ScopedEnvironmentVariable &operator=(const ScopedEnvironmentVariable &) = delete;
+
+  private:
+    std::string name_;
+    std::string previous_value_;
+    bool was_set_ = false;
+};
+
+// Creates an empty directory in the test temporary directory, and removes it along with its contents when destroyed, also when an
+// assertion ends the test early
+class ScopedTempDirectory {
+  public:
+    explicit ScopedTempDirectory(const char *name);
+    ~ScopedTempDirectory();
+    ScopedTempDirectory(const ScopedTempDirectory &) = delete;
+    ScopedTempDirectory &operator=(const ScopedTempDirectory &) = delete;
+
+    const std::filesystem::path &Path() const { return path_; }
+
+  private:
+    std::filesystem::path path_;
+};
+
 void ReleaseNullFence(ThreadTestData *);
 
 void TestRenderPassCreate(ErrorMonitor *error_monitor, const VkDevice device, const VkRenderPassCreateInfo *create_info,
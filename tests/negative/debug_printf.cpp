@@ -13,6 +13,11 @@
 
 #include "../framework/layer_validation_tests.h"
 
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <tuple>
+
 void NegativeDebugPrintf::InitDebugPrintfFramework() {
     VkValidationFeatureEnableEXT enables[] = {VK_VALIDATION_FEATURE_ENABLE_DEBUG_PRINTF_EXT};
     VkValidationFeatureDisableEXT disables[] = {
@@ -1067,3 +1072,116 @@ TEST_F(NegativeDebugPrintf, GPLFragmentIndependentSets) {
     vk::QueueWaitIdle(m_device->m_queue);
     m_errorMonitor->VerifyFound();
 }
+
+TEST_F(NegativeDebugPrintf, LogFile) {
+    TEST_DESCRIPTION("Write Debug Printf output to a log file, and check that another device logging to it does not truncate it");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+    AddRequiredExtensions(VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME);
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The printf_log_file setting is given through the environment";
+#endif
+    ScopedTempDirectory log_dir("vvl_debug_printf_log_file");
+    const std::string log_file = (log_dir.Path() / "debug_printf_log.bin").string();
+    ScopedEnvironmentVariable printf_log_file("VK_LAYER_PRINTF_LOG_FILE", log_file.c_str());
+    InitDebugPrintfFramework();
+    if (!AreRequiredExtensionsEnabled()) {
+        GTEST_SKIP() << RequiredExtensionsNotSupported() << " not supported";
+    }
+    if (IsPlatform(kMockICD)) {
+        GTEST_SKIP() << "Test not supported by MockICD, GPU-Assisted validation test requires a driver that can dispatch";
+    }
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    char const *cs_source = R"glsl(
+        #version 450
+        #extension GL_EXT_debug_printf : enable
+        void main() {
+            int foo = -135;
+            debugPrintfEXT("Here's an integer %i and a float %1.2f", foo, 3.1415f);
+            debugPrintfEXT("Here's a vector of floats %1.2v2f", vec2(1.2f, 2.2f));
+        }
+    )glsl";
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_ = std::make_unique<VkShaderObj>(this, cs_source, VK_SHADER_STAGE_COMPUTE_BIT, SPV_ENV_VULKAN_1_1);
+    pipe.InitState();
+    pipe.CreateComputePipeline();
+
+    m_commandBuffer->begin();
+    vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    m_commandBuffer->end();
+
+    // The log is written once the command buffer's output has been processed, without waiting for the device to be destroyed
+    m_commandBuffer->QueueCommandBuffer();
+    vk::QueueWaitIdle(m_device->m_queue);
+
+    // Another device logging to the same file appends to it
+    { VkDeviceObj second_device(0, gpu()); }
+
+    std::vector<uint32_t> words;
+    {
+        std::ifstream file(log_file, std::ios::binary);
+        ASSERT_TRUE(file.is_open());
+        words.resize(std::filesystem::file_size(log_file) / sizeof(uint32_t));
+        file.read(reinterpret_cast<char *>(words.data()), words.size() * sizeof(uint32_t));
+    }
+
+    // The layout is described in layers/gpu_validation/debug_printf_log.h
+    ASSERT_GE(words.size(), 2u);
+    ASSERT_EQ(words[0], 0x46505644u);
+    ASSERT_EQ(words[1], 2u);
+    // Format strings by device id, shader id and format string id
+    std::map<std::tuple<uint32_t, uint32_t, uint32_t>, std::string> format_strings;
+    // Format string and values of each logged record
+    std::vector<std::pair<std::string, std::vector<uint32_t>>> messages;
+    size_t offset = 2;
+    while (offset < words.size()) {
+        ASSERT_LE(offset + 2, words.size());
+        const uint32_t entry = words[offset];
+        const uint32_t device_id = words[offset + 1];
+        if (entry == 1) {
+            ASSERT_LE(offset + 5, words.size());
+            const uint32_t length = words[offset + 4];
+            const size_t string_words = (length + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+            ASSERT_LE(offset + 5 + string_words, words.size());
+            format_strings[{device_id, words[offset + 2], words[offset + 3]}] =
+                std::string(reinterpret_cast<const char *>(&words[offset + 5]), length);
+            offset += 5 + string_words;
+        } else if (entry == 2) {
+            ASSERT_LE(offset + 7, words.size());
+            ASSERT_EQ(words[offset + 4], static_cast<uint32_t>(VK_PIPELINE_BIND_POINT_COMPUTE));
+            const size_t records_end = offset + 7 + words[offset + 6];
+            ASSERT_LE(records_end, words.size());
+            for (offset += 7; offset < records_end; offset += words[offset]) {
+                // Word 0 of a record is its size, word 1 the shader id, word 7 the format string id and the values follow
+                ASSERT_GE(words[offset], 8u);
+                ASSERT_LE(offset + words[offset], records_end);
+                const auto format_string = format_strings.find({device_id, words[offset + 1], words[offset + 7]});
+                ASSERT_NE(format_string, format_strings.end());
+                messages.emplace_back(format_string->second,
+                                      std::vector<uint32_t>(words.begin() + offset + 8, words.begin() + offset + words[offset]));
+            }
+        } else {
+            FAIL() << "Unknown entry " << entry << " at word " << offset;
+        }
+    }
+
+    const auto as_float = [](uint32_t word) {
+        float value;
+        std::memcpy(&value, &word, sizeof(value));
+        return value;
+    };
+    ASSERT_EQ(messages.size(), 2u);
+    ASSERT_EQ(messages[0].first, "Here's an integer %i and a float %1.2f");
+    ASSERT_EQ(messages[0].second.size(), 2u);
+    ASSERT_EQ(static_cast<int32_t>(messages[0].second[0]), -135);
+    ASSERT_FLOAT_EQ(as_float(messages[0].second[1]), 3.1415f);
+    ASSERT_EQ(messages[1].first, "Here's a vector of floats %1.2v2f");
+    ASSERT_EQ(messages[1].second.size(), 2u);
+    ASSERT_FLOAT_EQ(as_float(messages[1].second[0]), 1.2f);
+    ASSERT_FLOAT_EQ(as_float(messages[1].second[1]), 2.2f);
+
+    // Close the file before the directory is removed
+    ShutdownFramework();
+}
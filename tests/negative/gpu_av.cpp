@@ -2597,3 +2597,177 @@ TEST_F(VkGpuAssistedLayerTest, GpuBufferOOBGPLIndependentSets) {
         vk::QueueWaitIdle(m_device->m_queue);
     }
 }
+
+TEST_F(VkGpuAssistedLayerTest, InstrumentedShaderCache) {
+    TEST_DESCRIPTION("Report an out of bounds access in a shader module instrumented from the instrumented shader cache");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The gpuav_shader_cache setting is given through the environment";
+#endif
+    // The cache file goes in the user cache directory, point that at an empty directory so the first lookup always misses
+    ScopedTempDirectory cache_dir("vvl_instrumented_shader_cache");
+    ScopedEnvironmentVariable cache_home("XDG_CACHE_HOME", cache_dir.Path().string().c_str());
+    ScopedEnvironmentVariable gpuav_shader_cache("VK_LAYER_GPUAV_SHADER_CACHE", "true");
+    VkValidationFeaturesEXT validation_features = GetValidationFeatures();
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &validation_features));
+    if (!CanEnableGpuAV()) {
+        GTEST_SKIP() << "Requirements for GPU-AV are not met";
+    }
+    VkPhysicalDeviceFeatures features = {};  // Make sure robust buffer access is not enabled
+    ASSERT_NO_FATAL_FAILURE(InitState(&features, nullptr, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    {
+        VkBufferObj write_buffer;
+        write_buffer.init_as_storage(*m_device, 16, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        char const *cs_source = R"glsl(
+            #version 450
+            layout(set = 0, binding = 0) buffer StorageBuffer { uint data[]; } Data;
+            void main() {
+                Data.data[8] = 1;
+            }
+        )glsl";
+
+        // The first pipeline instruments the shader and adds it to the cache, the second gets its module from the cache, with
+        // its own shader id patched in
+        for (uint32_t i = 0; i < 2; ++i) {
+            CreateComputePipelineHelper pipe(*this);
+            pipe.InitInfo();
+            pipe.cs_ = std::make_unique<VkShaderObj>(this, cs_source, VK_SHADER_STAGE_COMPUTE_BIT);
+            pipe.dsl_bindings_ = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr}};
+            pipe.InitState();
+            pipe.CreateComputePipeline();
+            pipe.descriptor_set_->WriteDescriptorBufferInfo(0, write_buffer.handle(), 0, 16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+            pipe.descriptor_set_->UpdateDescriptorSets();
+
+            m_commandBuffer->begin();
+            vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+            vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(),
+                                      0, 1, &pipe.descriptor_set_->set_, 0, nullptr);
+            vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+            m_commandBuffer->end();
+
+            m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Descriptor size is 16 and highest byte accessed was 35");
+            m_commandBuffer->QueueCommandBuffer();
+            vk::QueueWaitIdle(m_device->m_queue);
+            m_errorMonitor->VerifyFound();
+            m_commandBuffer->reset();
+        }
+    }
+
+    // The cache is written when the device is destroyed, which has to happen before the directory is removed
+    ShutdownFramework();
+    ASSERT_FALSE(std::filesystem::is_empty(cache_dir.Path()));
+}
+
+TEST_F(VkGpuAssistedLayerTest, AsyncInstrumentation) {
+    TEST_DESCRIPTION("Report an out of bounds access in a pipeline whose shader module was instrumented in the background");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The gpuav_async_instrumentation setting is given through the environment";
+#endif
+    ScopedEnvironmentVariable gpuav_async_instrumentation("VK_LAYER_GPUAV_ASYNC_INSTRUMENTATION", "true");
+    VkValidationFeaturesEXT validation_features = GetValidationFeatures();
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &validation_features));
+    if (!CanEnableGpuAV()) {
+        GTEST_SKIP() << "Requirements for GPU-AV are not met";
+    }
+    VkPhysicalDeviceFeatures features = {};  // Make sure robust buffer access is not enabled
+    ASSERT_NO_FATAL_FAILURE(InitState(&features, nullptr, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    VkBufferObj write_buffer;
+    write_buffer.init_as_storage(*m_device, 16, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    char const *cs_source = R"glsl(
+        #version 450
+        layout(set = 0, binding = 0) buffer StorageBuffer { uint data[]; } Data;
+        void main() {
+            Data.data[8] = 1;
+        }
+    )glsl";
+
+    // Modules that are never used in a pipeline, so their instrumentation may still be queued when the device is destroyed
+    std::vector<std::unique_ptr<VkShaderObj>> unused_modules;
+    for (uint32_t i = 0; i < 8; ++i) {
+        unused_modules.emplace_back(std::make_unique<VkShaderObj>(this, cs_source, VK_SHADER_STAGE_COMPUTE_BIT));
+    }
+
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_ = std::make_unique<VkShaderObj>(this, cs_source, VK_SHADER_STAGE_COMPUTE_BIT);
+    pipe.dsl_bindings_ = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr}};
+    pipe.InitState();
+    pipe.CreateComputePipeline();
+    pipe.descriptor_set_->WriteDescriptorBufferInfo(0, write_buffer.handle(), 0, 16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    pipe.descriptor_set_->UpdateDescriptorSets();
+
+    m_commandBuffer->begin();
+    vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+    vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(), 0, 1,
+                              &pipe.descriptor_set_->set_, 0, nullptr);
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    m_commandBuffer->end();
+
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Descriptor size is 16 and highest byte accessed was 35");
+    m_commandBuffer->QueueCommandBuffer();
+    vk::QueueWaitIdle(m_device->m_queue);
+    m_errorMonitor->VerifyFound();
+}
+
+TEST_F(VkGpuAssistedLayerTest, AsyncProcessing) {
+    TEST_DESCRIPTION("Report an out of bounds access from the processing worker, by the time the submission's fence is signaled");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The gpuav_async_processing setting is given through the environment";
+#endif
+    ScopedEnvironmentVariable gpuav_async_processing("VK_LAYER_GPUAV_ASYNC_PROCESSING", "true");
+    VkValidationFeaturesEXT validation_features = GetValidationFeatures();
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &validation_features));
+    if (!CanEnableGpuAV()) {
+        GTEST_SKIP() << "Requirements for GPU-AV are not met";
+    }
+    VkPhysicalDeviceFeatures features = {};  // Make sure robust buffer access is not enabled
+    ASSERT_NO_FATAL_FAILURE(InitState(&features, nullptr, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    VkBufferObj write_buffer;
+    write_buffer.init_as_storage(*m_device, 16, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    char const *cs_source = R"glsl(
+        #version 450
+        layout(set = 0, binding = 0) buffer StorageBuffer { uint data[]; } Data;
+        void main() {
+            Data.data[8] = 1;
+        }
+    )glsl";
+
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_ = std::make_unique<VkShaderObj>(this, cs_source, VK_SHADER_STAGE_COMPUTE_BIT);
+    pipe.dsl_bindings_ = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr}};
+    pipe.InitState();
+    pipe.CreateComputePipeline();
+    pipe.descriptor_set_->WriteDescriptorBufferInfo(0, write_buffer.handle(), 0, 16, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    pipe.descriptor_set_->UpdateDescriptorSets();
+
+    m_commandBuffer->begin();
+    vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+    vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(), 0, 1,
+                              &pipe.descriptor_set_->set_, 0, nullptr);
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    m_commandBuffer->end();
+
+    // Submit twice, so that the second submission waits for the worker to be done with the output of the first
+    for (uint32_t i = 0; i < 2; ++i) {
+        vk_testing::Fence fence(*m_device);
+        VkSubmitInfo submit_info = LvlInitStruct<VkSubmitInfo>();
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &m_commandBuffer->handle();
+        // The worker reports the message, vkGetFenceStatus waits for it once the fence is signaled
+        m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Descriptor size is 16 and highest byte accessed was 35");
+        ASSERT_VK_SUCCESS(vk::QueueSubmit(m_device->m_queue, 1, &submit_info, fence.handle()));
+        while (vk::GetFenceStatus(m_device->device(), fence.handle()) == VK_NOT_READY) {
+        }
+        m_errorMonitor->VerifyFound();
+    }
+    vk::QueueWaitIdle(m_device->m_queue);
+}
@@ -3025,6 +3025,42 @@ TEST_F(VkLayerTest, CreatePipelineMissingEntrypoint) {
     }
 }
 
+TEST_F(VkLayerTest, CreatePipelineMissingEntrypointParallel) {
+    TEST_DESCRIPTION("Report every missing entrypoint of a batch large enough to be validated on the pipeline worker threads");
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The pipeline_validation_threads setting is given through the environment";
+#endif
+    ScopedEnvironmentVariable pipeline_validation_threads("VK_LAYER_PIPELINE_VALIDATION_THREADS", "4");
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    CreateComputePipelineHelper pipe_0(*this);  // valid
+    pipe_0.InitInfo();
+    pipe_0.InitState();
+    pipe_0.LateBindPipelineInfo();
+    CreateComputePipelineHelper pipe_1(*this);  // invalid
+    pipe_1.InitInfo();
+    pipe_1.cs_.reset(new VkShaderObj(this, bindStateMinimalShaderText, VK_SHADER_STAGE_COMPUTE_BIT, SPV_ENV_VULKAN_1_0,
+                                     SPV_SOURCE_GLSL, nullptr, "foo"));
+    pipe_1.InitState();
+    pipe_1.LateBindPipelineInfo();
+
+    constexpr uint32_t pipeline_count = 64;
+    std::vector<VkComputePipelineCreateInfo> create_infos(pipeline_count, pipe_0.cp_ci_);
+    for (uint32_t i = 5; i < pipeline_count; i += 16) {
+        create_infos[i] = pipe_1.cp_ci_;
+        m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "VUID-VkPipelineShaderStageCreateInfo-pName-00707");
+    }
+    std::vector<VkPipeline> pipelines(pipeline_count, VK_NULL_HANDLE);
+    vk::CreateComputePipelines(m_device->device(), VK_NULL_HANDLE, pipeline_count, create_infos.data(), nullptr,
+                               pipelines.data());
+    m_errorMonitor->VerifyFound();
+    for (VkPipeline pipeline : pipelines) {
+        if (pipeline != VK_NULL_HANDLE) {
+            vk::DestroyPipeline(m_device->device(), pipeline, nullptr);
+        }
+    }
+}
+
 TEST_F(VkLayerTest, CreatePipelineDepthStencilRequired) {
     m_errorMonitor->SetDesiredFailureMsg(
         kErrorBit, "pDepthStencilState is NULL when rasterization is enabled and subpass uses a depth/stencil attachment");
@@ -1957,3 +1957,87 @@ TEST_F(NegativeRayTracing, MissingEntrypointNV) {
     };
     CreateNVRayTracingPipelineHelper::OneshotTest(*this, set_info, "VUID-VkPipelineShaderStageCreateInfo-pName-00707");
 }
+
+TEST_F(NegativeRayTracing, DeferredOperationSpecialization) {
+    TEST_DESCRIPTION("Make sure specialization constants are applied before a call with a deferred operation is made.");
+    SetTargetApiVersion(VK_API_VERSION_1_2);
+
+    auto ray_tracing_features = LvlInitStruct<VkPhysicalDeviceRayTracingPipelineFeaturesKHR>();
+    auto features2 = LvlInitStruct<VkPhysicalDeviceFeatures2KHR>(&ray_tracing_features);
+    if (!InitFrameworkForRayTracingTest(this, true, &features2)) {
+        GTEST_SKIP() << "unable to init ray tracing test";
+    }
+    // Needed for Ray Tracing
+    if (DeviceValidationVersion() < VK_API_VERSION_1_2) {
+        GTEST_SKIP() << "At least Vulkan version 1.2 is required";
+    }
+    if (!ray_tracing_features.rayTracingPipeline) {
+        GTEST_SKIP() << "Feature rayTracing is not supported.";
+    }
+
+    ASSERT_NO_FATAL_FAILURE(InitState(nullptr, &features2));
+
+    // Size an array using a specialization constant of default value equal to 1.
+    const char *rgen_src = R"glsl(
+        #version 460
+        #extension GL_EXT_ray_tracing : require
+        layout(constant_id = 0) const int size = 1;
+        void main() {
+            float array[size];
+            array[0] = 0.0;
+        }
+    )glsl";
+    VkShaderObj rgen_shader(this, rgen_src, VK_SHADER_STAGE_RAYGEN_BIT_KHR, SPV_ENV_VULKAN_1_2);
+
+    const auto vkCreateRayTracingPipelinesKHR =
+        GetInstanceProcAddr<PFN_vkCreateRayTracingPipelinesKHR>("vkCreateRayTracingPipelinesKHR");
+    const auto vkCreateDeferredOperationKHR = GetInstanceProcAddr<PFN_vkCreateDeferredOperationKHR>("vkCreateDeferredOperationKHR");
+    const auto vkDestroyDeferredOperationKHR =
+        GetInstanceProcAddr<PFN_vkDestroyDeferredOperationKHR>("vkDestroyDeferredOperationKHR");
+
+    const VkPipelineLayoutObj empty_pipeline_layout(m_device, {});
+
+    const VkSpecializationMapEntry entry = {
+        0,                // id
+        0,                // offset
+        sizeof(uint32_t)  // size
+    };
+    uint32_t data = 0;
+    const VkSpecializationInfo specialization_info = {
+        1,
+        &entry,
+        1 * sizeof(uint32_t),
+        &data,
+    };
+
+    VkPipelineShaderStageCreateInfo stage_create_info = LvlInitStruct<VkPipelineShaderStageCreateInfo>();
+    stage_create_info.stage = VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+    stage_create_info.module = rgen_shader.handle();
+    stage_create_info.pName = "main";
+    stage_create_info.pSpecializationInfo = &specialization_info;
+
+    VkRayTracingShaderGroupCreateInfoKHR group_create_info = LvlInitStruct<VkRayTracingShaderGroupCreateInfoKHR>();
+    group_create_info.type = VK_RAY_TRACING_SHADER_GROUP_TYPE_GENERAL_KHR;
+    group_create_info.generalShader = 0;
+    group_create_info.closestHitShader = VK_SHADER_UNUSED_KHR;
+    group_create_info.anyHitShader = VK_SHADER_UNUSED_KHR;
+    group_create_info.intersectionShader = VK_SHADER_UNUSED_KHR;
+
+    VkRayTracingPipelineCreateInfoKHR pipeline_ci = LvlInitStruct<VkRayTracingPipelineCreateInfoKHR>();
+    pipeline_ci.stageCount = 1;
+    pipeline_ci.pStages = &stage_create_info;
+    pipeline_ci.groupCount = 1;
+    pipeline_ci.pGroups = &group_create_info;
+    pipeline_ci.layout = empty_pipeline_layout.handle();
+
+    VkDeferredOperationKHR deferred_operation = VK_NULL_HANDLE;
+    ASSERT_VK_SUCCESS(vkCreateDeferredOperationKHR(m_device->handle(), 0, &deferred_operation));
+
+    // Applying the specialization constant makes the shader invalid, which must fail the call rather than be reported later
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "VUID-VkPipelineShaderStageCreateInfo-pSpecializationInfo-06719");
+    vkCreateRayTracingPipelinesKHR(m_device->handle(), deferred_operation, VK_NULL_HANDLE, 1, &pipeline_ci, nullptr, &pipeline);
+    m_errorMonitor->VerifyFound();
+
+    vkDestroyDeferredOperationKHR(m_device->handle(), deferred_operation, nullptr);
+}
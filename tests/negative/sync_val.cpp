@@ -211,6 +211,52 @@ TEST_F(NegativeSyncVal, BufferCopyHazards) {
     }
 }
 
+TEST_F(NegativeSyncVal, SecondaryExecutedRepeatedly) {
+    TEST_DESCRIPTION("Execute the same secondary command buffer several times, re-recording it in between.");
+    ASSERT_NO_FATAL_FAILURE(InitSyncValFramework());
+    ASSERT_NO_FATAL_FAILURE(InitState(nullptr, nullptr, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    VkBufferObj buffer_a;
+    VkBufferObj buffer_b;
+    VkMemoryPropertyFlags mem_prop = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    buffer_a.init_as_src_and_dst(*m_device, 256, mem_prop);
+    buffer_b.init_as_src_and_dst(*m_device, 256, mem_prop);
+
+    VkBufferCopy front2front = {0, 0, 128};
+    VkBufferCopy back2back = {128, 128, 128};
+
+    VkCommandBufferObj secondary_cb(m_device, m_commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    VkCommandBuffer scb = secondary_cb.handle();
+    secondary_cb.begin();
+    vk::CmdCopyBuffer(scb, buffer_a.handle(), buffer_b.handle(), 1, &front2front);
+    secondary_cb.end();
+
+    auto cb = m_commandBuffer->handle();
+
+    // The second execution of the same secondary hazards with the first
+    m_commandBuffer->begin();
+    vk::CmdExecuteCommands(cb, 1, &scb);
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-WRITE-AFTER-WRITE");
+    vk::CmdExecuteCommands(cb, 1, &scb);
+    m_errorMonitor->VerifyFound();
+    m_commandBuffer->end();
+
+    // Re-recording the secondary must not reuse the state of the previous recording
+    secondary_cb.reset();
+    secondary_cb.begin();
+    vk::CmdCopyBuffer(scb, buffer_a.handle(), buffer_b.handle(), 1, &back2back);
+    secondary_cb.end();
+
+    m_commandBuffer->reset();
+    m_commandBuffer->begin();
+    vk::CmdCopyBuffer(cb, buffer_a.handle(), buffer_b.handle(), 1, &front2front);
+    vk::CmdExecuteCommands(cb, 1, &scb);
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-WRITE-AFTER-WRITE");
+    vk::CmdExecuteCommands(cb, 1, &scb);
+    m_errorMonitor->VerifyFound();
+    m_commandBuffer->end();
+}
+
 TEST_F(NegativeSyncVal, BufferCopyHazardsSync2) {
     SetTargetApiVersion(VK_API_VERSION_1_2);
     AddRequiredExtensions(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
@@ -4709,6 +4755,37 @@ TEST_F(NegativeSyncVal, QSBufferCopyHazards) {
     test.DeviceWait();
 }
 
+TEST_F(NegativeSyncVal, QSAccessLogBudget) {
+    TEST_DESCRIPTION("Report a hazard whose prior usage record was evicted to stay within the access log budget");
+#if defined(VK_USE_PLATFORM_ANDROID_KHR)
+    GTEST_SKIP() << "The syncval_access_log_budget setting is given through the environment";
+#endif
+    // Enable QueueSubmit validation, keeping a single usage record per queue
+    ScopedEnvironmentVariable access_log_budget("VK_LAYER_SYNCVAL_ACCESS_LOG_BUDGET", "1");
+    ASSERT_NO_FATAL_FAILURE(InitSyncValFramework(true));
+    ASSERT_NO_FATAL_FAILURE(InitState(nullptr, nullptr, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+
+    QSTestContext test(m_device, m_device->m_queue_obj);
+    if (!test.Valid()) {
+        GTEST_SKIP() << "Test requires a valid queue object.";
+    }
+
+    test.RecordCopy(test.cba, test.buffer_a, test.buffer_b);
+    test.RecordCopy(test.cbb, test.buffer_a, test.buffer_c);
+    test.RecordCopy(test.cbc, test.buffer_a, test.buffer_b);
+
+    // Both submissions keep their copies referenced, but only the record of the second one fits in the budget
+    test.Submit0(test.cba);
+    test.Submit0(test.cbb);
+
+    // The write after write hazard on buffer_b has the evicted write by cba as its prior usage
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "usage record discarded");
+    test.Submit0(test.cbc);
+    m_errorMonitor->VerifyFound();
+
+    test.DeviceWait();
+}
+
 TEST_F(NegativeSyncVal, QSSubmit2) {
     SetTargetApiVersion(VK_API_VERSION_1_3);
     ASSERT_NO_FATAL_FAILURE(InitSyncValFramework(true));  // Enable QueueSubmit validation
@@ -2569,3 +2569,34 @@ TEST_F(VkPositiveLayerTest, UnnormalizedCoordinatesNotSampled) {
     m_commandBuffer->EndRenderPass();
     m_commandBuffer->end();
 }
+
+TEST_F(VkPositiveLayerTest, IdenticalShaderModules) {
+    TEST_DESCRIPTION("Create pipelines from shader modules with identical SPIR-V, which share their parsed SPIR-V in the layer");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    char const *csSource = R"glsl(
+        #version 450
+        layout(set = 0, binding = 0) buffer SSBO { uint x; };
+        void main() {
+            x = 1;
+        }
+    )glsl";
+
+    CreateComputePipelineHelper first_pipe(*this);
+    first_pipe.InitInfo();
+    first_pipe.cs_.reset(new VkShaderObj(this, csSource, VK_SHADER_STAGE_COMPUTE_BIT));
+    first_pipe.dsl_bindings_ = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    first_pipe.InitState();
+    first_pipe.CreateComputePipeline();
+
+    // The parse is shared with the first pipeline, so must outlive the module it was first made for
+    first_pipe.cs_.reset();
+
+    CreateComputePipelineHelper second_pipe(*this);
+    second_pipe.InitInfo();
+    second_pipe.cs_.reset(new VkShaderObj(this, csSource, VK_SHADER_STAGE_COMPUTE_BIT));
+    second_pipe.dsl_bindings_ = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    second_pipe.InitState();
+    second_pipe.CreateComputePipeline();
+}
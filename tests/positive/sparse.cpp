@@ -382,3 +382,96 @@ TEST_F(PositiveSparse, BufferOverlapCopy) {
     // Wait for operations to finish before destroying anything
     vk::QueueWaitIdle(m_device->m_queue);
 }
+
+TEST_F(PositiveSparse, BufferPageBinds) {
+    TEST_DESCRIPTION("Bind sparse buffers page by page to disjoint ranges of the same memory, rebinding some pages, then copy");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    if (!m_device->phy().features().sparseBinding) {
+        GTEST_SKIP() << "Requires unsupported sparseBinding feature.";
+    }
+
+    const std::optional<uint32_t> sparse_index = m_device->QueueFamilyMatching(VK_QUEUE_SPARSE_BINDING_BIT, 0u);
+    if (!sparse_index) {
+        GTEST_SKIP() << "Required queue families not present";
+    }
+    VkQueue sparse_queue = m_device->graphics_queues()[sparse_index.value()]->handle();
+
+    auto s_info = LvlInitStruct<VkSemaphoreCreateInfo>();
+    vk_testing::Semaphore semaphore(*m_device, s_info);
+
+    VkBufferCreateInfo b_info = vk_testing::Buffer::create_info(
+        16 * 65536, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, nullptr);
+    b_info.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT;
+    VkBufferObj buffer_sparse;
+    buffer_sparse.init_no_mem(*m_device, b_info);
+    VkBufferObj buffer_sparse2;
+    buffer_sparse2.init_no_mem(*m_device, b_info);
+
+    VkMemoryRequirements buffer_mem_reqs;
+    vk::GetBufferMemoryRequirements(device(), buffer_sparse.handle(), &buffer_mem_reqs);
+    const VkDeviceSize page_size = buffer_mem_reqs.alignment;
+    const uint32_t page_count = static_cast<uint32_t>(buffer_mem_reqs.size / page_size);
+
+    // Both buffers share one allocation, the first one in its lower half and the second one in its upper half
+    VkMemoryRequirements shared_mem_reqs = buffer_mem_reqs;
+    shared_mem_reqs.size = 2 * buffer_mem_reqs.size;
+    VkMemoryAllocateInfo buffer_mem_alloc =
+        vk_testing::DeviceMemory::get_resource_alloc_info(*m_device, shared_mem_reqs, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vk_testing::DeviceMemory buffer_mem;
+    buffer_mem.init(*m_device, buffer_mem_alloc);
+
+    // The pages of the second buffer are bound in reverse order, and the first page of the first buffer is bound 3 times
+    std::vector<VkSparseMemoryBind> binds;
+    std::vector<VkSparseMemoryBind> binds2;
+    for (uint32_t page = 0; page < page_count; ++page) {
+        VkSparseMemoryBind bind = {};
+        bind.resourceOffset = page * page_size;
+        bind.size = page_size;
+        bind.memory = buffer_mem.handle();
+        bind.memoryOffset = page * page_size;
+        binds.emplace_back(bind);
+        bind.resourceOffset = (page_count - page - 1) * page_size;
+        bind.memoryOffset = buffer_mem_reqs.size + bind.resourceOffset;
+        binds2.emplace_back(bind);
+    }
+    binds.emplace_back(binds.front());
+    binds.emplace_back(binds.front());
+
+    VkSparseBufferMemoryBindInfo buffer_memory_bind_infos[2] = {};
+    buffer_memory_bind_infos[0].buffer = buffer_sparse.handle();
+    buffer_memory_bind_infos[0].bindCount = static_cast<uint32_t>(binds.size());
+    buffer_memory_bind_infos[0].pBinds = binds.data();
+    buffer_memory_bind_infos[1].buffer = buffer_sparse2.handle();
+    buffer_memory_bind_infos[1].bindCount = static_cast<uint32_t>(binds2.size());
+    buffer_memory_bind_infos[1].pBinds = binds2.data();
+
+    auto bind_info = LvlInitStruct<VkBindSparseInfo>();
+    bind_info.bufferBindCount = 2;
+    bind_info.pBufferBinds = buffer_memory_bind_infos;
+    bind_info.signalSemaphoreCount = 1;
+    bind_info.pSignalSemaphores = &semaphore.handle();
+    vk::QueueBindSparse(sparse_queue, 1, &bind_info, VK_NULL_HANDLE);
+
+    VkBufferCopy copy_info;
+    copy_info.srcOffset = 0;
+    copy_info.dstOffset = 0;
+    copy_info.size = b_info.size;
+
+    m_commandBuffer->begin();
+    vk::CmdCopyBuffer(m_commandBuffer->handle(), buffer_sparse.handle(), buffer_sparse2.handle(), 1, &copy_info);
+    m_commandBuffer->end();
+
+    VkPipelineStageFlags mask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    auto submit_info = LvlInitStruct<VkSubmitInfo>();
+    submit_info.waitSemaphoreCount = 1;
+    submit_info.pWaitSemaphores = &semaphore.handle();
+    submit_info.pWaitDstStageMask = &mask;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &m_commandBuffer->handle();
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+
+    // Wait for operations to finish before destroying anything
+    vk::QueueWaitIdle(m_device->m_queue);
+}